@@ -0,0 +1,298 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_COMPACT_VIRTUAL_PTR_HPP
+#define BOOST_OPENMETHOD_COMPACT_VIRTUAL_PTR_HPP
+
+#include <boost/openmethod/core.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if !defined(__linux__) || !(defined(__x86_64__) || defined(__aarch64__))
+#error "compact_virtual_ptr requires x86-64 or AArch64 Linux"
+#endif
+
+namespace boost::openmethod {
+
+//! Pointer to an object and its v-table, packed in a single word.
+//!
+//! A `compact_virtual_ptr` holds the same information as a @ref virtual_ptr,
+//! in half the space. On x86-64 and AArch64 Linux, user space addresses fit in
+//! the low 48 bits of a pointer. `compact_virtual_ptr` stores the address of
+//! the object in these bits, and, in the high 16 bits, the index of the
+//! object's class in a table of v-table pointers, rebuilt by @ref initialize.
+//! Recovering the v-table pointer costs a shift and a load from the table, plus
+//! a load if `Registry` contains the @ref indirect_vptr policy; recovering the
+//! object pointer costs a mask.
+//!
+//! A `compact_virtual_ptr` converts implicitly to a plain @ref virtual_ptr, so
+//! it can be passed to a method that takes a `virtual_ptr` parameter. It is
+//! meant for large collections of objects, which take less cache space than
+//! with `virtual_ptr`, at the cost of an extra load per call.
+//!
+//! The index of a class is assigned when the class is registered, and does not
+//! change when the registry is initialized again. Thus, unlike `virtual_ptr`,
+//! `compact_virtual_ptr` remains valid after a call to @ref initialize, for
+//! example after loading a shared library.
+//!
+//! Constructing a `compact_virtual_ptr` from an object, or from a
+//! `virtual_ptr`, obtains the dynamic type of the object from the registry's
+//! @ref rtti policy, then finds the index of the class by binary search in a
+//! table sorted by `type_id`. @ref final does not search.
+//!
+//! The tables used by `compact_virtual_ptr` are built by @ref initialize only
+//! if `compact_virtual_ptr` is used with `Registry`.
+//!
+//! @par Requirements
+//!
+//! @li No more than 65535 classes registered in `Registry`.
+//!
+//! @par Errors
+//!
+//! If `Registry` contains the @ref runtime_checks policy, the following errors
+//! may occur. The registry's @ref error_handler, if it has one, is called with
+//! the error, then the program is terminated with @ref abort.
+//!
+//! @li @ref missing_class: The class of the object is not registered.
+//!
+//! @li @ref compact_vptr_overflow: The index of the class does not fit in 16
+//! bits.
+//!
+//! @li @ref compact_address_overflow: The address of the object does not fit in
+//! 48 bits.
+//!
+//! @tparam Class The class of the object, possibly cv-qualified.
+//! @tparam Registry The registry in which `Class` is registered.
+template<class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY>
+class compact_virtual_ptr {
+    using registry_type = typename Registry::registry_type;
+
+    static constexpr unsigned address_bits = 48;
+    static constexpr std::uintptr_t address_mask =
+        (std::uintptr_t(1) << address_bits) - 1;
+
+    std::uintptr_t bits;
+
+    static auto pack(Class* obj, std::uint32_t index, type_id type)
+        -> std::uintptr_t {
+        (void)&detail::use_compact_vptrs<registry_type>;
+
+        auto address = reinterpret_cast<std::uintptr_t>(obj);
+
+        if constexpr (Registry::has_runtime_checks) {
+            if ((address & ~address_mask) != 0) {
+                if constexpr (Registry::has_error_handler) {
+                    compact_address_overflow error;
+                    error.type = type;
+                    error.address = obj;
+                    Registry::error_handler::error(error);
+                }
+
+                abort();
+            }
+
+            if (index >= (std::uint32_t(1) << (64 - address_bits))) {
+                if constexpr (Registry::has_error_handler) {
+                    compact_vptr_overflow error;
+                    error.type = type;
+                    Registry::error_handler::error(error);
+                }
+
+                abort();
+            }
+        }
+
+        (void)type;
+
+        return address | (std::uintptr_t(index) << address_bits);
+    }
+
+    template<class Other>
+    static auto pack(Other& obj) -> std::uintptr_t {
+        auto type = Registry::rtti::dynamic_type(obj);
+        auto& indexes = detail::compact_type_indexes<registry_type>;
+        auto iter = std::lower_bound(
+            indexes.begin(), indexes.end(), type,
+            [](const auto& entry, type_id type) {
+                return std::less<type_id>()(entry.first, type);
+            });
+
+        if (iter == indexes.end() || iter->first != type) {
+            if constexpr (Registry::has_runtime_checks) {
+                if constexpr (Registry::has_error_handler) {
+                    missing_class error;
+                    error.type = type;
+                    Registry::error_handler::error(error);
+                }
+
+                abort();
+            }
+
+            return pack(&obj, 0, type);
+        }
+
+        return pack(&obj, iter->second, type);
+    }
+
+  public:
+    //! Class
+    //!
+    //! This is the same as `Class`.
+    using element_type = Class;
+
+    //! Default constructor
+    //!
+    //! @note This constructor does nothing.
+    compact_virtual_ptr() = default;
+
+    //! Construct from `nullptr`
+    //!
+    //! @param value A `nullptr`.
+    explicit compact_virtual_ptr(std::nullptr_t) noexcept : bits(0) {
+        (void)&detail::use_compact_vptrs<registry_type>;
+    }
+
+    //! Construct from a `virtual_ptr`
+    //!
+    //! The v-table pointer held by `other` is not used. The index of the class
+    //! is found as when constructing from a reference: the dynamic type of the
+    //! object is obtained from the registry's @ref rtti policy, then looked up
+    //! by binary search, at a cost of O(log n) in the number of registered
+    //! classes.
+    //!
+    //! @tparam Other A polymorphic class convertible to `Class`.
+    //! @param other A plain `virtual_ptr` in the same registry.
+    template<
+        class Other,
+        typename = std::enable_if_t<
+            BOOST_OPENMETHOD_DETAIL_UNLESS_MRDOCS
+                IsPolymorphic<Other, Registry> &&
+            std::is_convertible_v<Other*, Class*>>>
+    compact_virtual_ptr(const virtual_ptr<Other, Registry>& other)
+        : bits(other.get() ? pack(*other.get()) : 0) {
+    }
+
+    //! Construct from a reference to an object
+    //!
+    //! The dynamic type of the object is obtained from the registry's @ref rtti
+    //! policy, then the index of the class is found by binary search, at a cost
+    //! of O(log n) in the number of registered classes. Unlike @ref
+    //! virtual_ptr, this does not use @ref boost_openmethod_vptr; thus `Other`
+    //! must be polymorphic. Use @ref final for classes that are not.
+    //!
+    //! @tparam Other A registered polymorphic class convertible to `Class`.
+    //! @param obj A reference to an object.
+    template<
+        class Other,
+        typename = std::enable_if_t<
+            BOOST_OPENMETHOD_DETAIL_UNLESS_MRDOCS
+                IsPolymorphic<Other, Registry> &&
+            std::is_convertible_v<Other*, Class*> &&
+            !detail::is_virtual_ptr<std::remove_cv_t<Other>>>>
+    compact_virtual_ptr(Other& obj) : bits(pack(obj)) {
+    }
+
+    //! Construct from an object of a known dynamic type
+    //!
+    //! The index of the class is read from a static variable.
+    //!
+    //! @tparam Other A registered class convertible to `Class`. It must be the
+    //! dynamic type of `obj`.
+    //! @param obj A reference to an object.
+    //! @return A `compact_virtual_ptr` pointing to `obj`.
+    template<class Other>
+    static auto final(Other& obj) -> compact_virtual_ptr {
+        using type = std::remove_cv_t<Other>;
+
+        compact_virtual_ptr result;
+        result.bits = pack(
+            &obj, detail::compact_vptr_index<registry_type, type>,
+            Registry::rtti::template static_type<type>());
+
+        return result;
+    }
+
+    //! Get a pointer to the object
+    //! @return A pointer to the object
+    auto get() const noexcept -> Class* {
+        return reinterpret_cast<Class*>(bits & address_mask);
+    }
+
+    //! Get a pointer to the object
+    //! @return A pointer to the object
+    auto operator->() const noexcept -> Class* {
+        return get();
+    }
+
+    //! Get a reference to the object
+    //! @return A reference to the object
+    auto operator*() const noexcept -> Class& {
+        return *get();
+    }
+
+    //! Get the v-table pointer
+    //! @return The v-table pointer
+    auto vptr() const noexcept -> vptr_type {
+        return detail::unbox_vptr(
+            detail::compact_vptrs<registry_type>[bits >> address_bits]);
+    }
+
+    //! Check if the pointer is not null
+    //! @return `true` if the object pointer is not null
+    explicit operator bool() const noexcept {
+        return (bits & address_mask) != 0;
+    }
+
+    //! Convert to a plain `virtual_ptr`
+    //!
+    //! @tparam Other A base class of `Class`, or `Class` itself.
+    //! @return A `virtual_ptr` pointing to the same object.
+    template<
+        class Other,
+        typename = std::enable_if_t<std::is_convertible_v<Class*, Other*>>>
+    operator virtual_ptr<Other, Registry>() const noexcept {
+        if (!*this) {
+            return virtual_ptr<Other, Registry>(nullptr);
+        }
+
+        // In indirect mode, the entry points to the `static_vptr` of the
+        // class, which remains valid after the table is rebuilt.
+        return virtual_ptr<Other, Registry>(
+            *get(), detail::compact_vptrs<registry_type>[bits >> address_bits]);
+    }
+
+    //! Compare two `compact_virtual_ptr`s for equality
+    //!
+    //! @param left A `compact_virtual_ptr`.
+    //! @param right A `compact_virtual_ptr`.
+    //! @return `true` if both point to the same object.
+    friend auto operator==(
+        const compact_virtual_ptr& left,
+        const compact_virtual_ptr& right) noexcept -> bool {
+        return left.get() == right.get();
+    }
+
+    //! Compare two `compact_virtual_ptr`s for inequality
+    //!
+    //! @param left A `compact_virtual_ptr`.
+    //! @param right A `compact_virtual_ptr`.
+    //! @return `true` if they point to different objects.
+    friend auto operator!=(
+        const compact_virtual_ptr& left,
+        const compact_virtual_ptr& right) noexcept -> bool {
+        return !(left == right);
+    }
+};
+
+namespace aliases {
+using boost::openmethod::compact_virtual_ptr;
+} // namespace aliases
+
+} // namespace boost::openmethod
+
+#endif
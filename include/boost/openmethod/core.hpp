@@ -56,6 +56,15 @@ template<
     typename = detail::sfinae>
 class virtual_ptr;
 
+template<class Class, class Registry>
+class compact_virtual_ptr;
+
+template<class Base, class Registry>
+class virtual_collection;
+
+template<class Method>
+class routing_table;
+
 // =============================================================================
 // Helpers
 
@@ -137,11 +146,23 @@ template<class B, class D>
 constexpr bool requires_dynamic_cast =
     detail::requires_dynamic_cast_ref_aux<B, D>::value;
 
+// Cast from a virtual base, using the registry's downcast policy if it has one,
+// and its rtti policy otherwise.
 template<class Registry, class D, class B>
-auto optimal_cast(B&& obj) -> decltype(auto) {
-    if constexpr (requires_dynamic_cast<B, D>) {
+auto dynamic_cast_ref(B&& obj) -> D {
+    if constexpr (Registry::has_downcast) {
+        return Registry::downcast::template dynamic_cast_ref<D>(
+            std::forward<B>(obj));
+    } else {
         return Registry::rtti::template dynamic_cast_ref<D>(
             std::forward<B>(obj));
+    }
+}
+
+template<class Registry, class D, class B>
+auto optimal_cast(B&& obj) -> decltype(auto) {
+    if constexpr (requires_dynamic_cast<B, D>) {
+        return detail::dynamic_cast_ref<Registry, D>(std::forward<B>(obj));
     } else {
         return static_cast<D>(obj);
     }
@@ -259,7 +280,8 @@ struct virtual_traits<Class&, Registry> {
     //! Cast to another type.
     //!
     //! Cast an object to another type. If possible, use `static_cast`.
-    //! Otherwise, use `Registry::rtti::dynamic_cast_ref`.
+    //! Otherwise, use the registry's @ref downcast policy if it has one, and
+    //! `Registry::rtti::dynamic_cast_ref` otherwise.
     //!
     //! @tparam Derived A lvalue reference type.
     //! @param obj A reference to a `Class` object.
@@ -290,7 +312,8 @@ struct virtual_traits<Class&&, Registry> {
     //! Cast to another type.
     //!
     //! Cast an object to another type. If possible, use `static_cast`.
-    //! Otherwise, use `Registry::rtti::dynamic_cast_ref`.
+    //! Otherwise, use the registry's @ref downcast policy if it has one, and
+    //! `Registry::rtti::dynamic_cast_ref` otherwise.
     //!
     //! @tparam Derived A rvalue reference type.
     //! @param obj A reference to a `Class` object.
@@ -321,7 +344,8 @@ struct virtual_traits<Class*, Registry> {
     //! Cast to another type.
     //!
     //! Cast an object to another type. If possible, use `static_cast`.
-    //! Otherwise, use `Registry::rtti::dynamic_cast_ref`.
+    //! Otherwise, use `Registry::downcast::dynamic_cast_ref` if the registry
+    //! has a @ref downcast policy, and `dynamic_cast` otherwise.
     //!
     //! @tparam Derived A pointer type.
     //! @param obj A pointer to a `Class` object.
@@ -331,7 +355,12 @@ struct virtual_traits<Class*, Registry> {
         static_assert(std::is_pointer_v<Derived>);
 
         if constexpr (detail::requires_dynamic_cast<Class*, Derived>) {
-            return dynamic_cast<Derived>(ptr);
+            if constexpr (Registry::has_downcast) {
+                return &detail::dynamic_cast_ref<
+                    Registry, std::remove_pointer_t<Derived>&>(*ptr);
+            } else {
+                return dynamic_cast<Derived>(ptr);
+            }
         } else {
             return static_cast<Derived>(ptr);
         }
@@ -354,6 +383,16 @@ struct use_class_aux<Registry, mp11::mp_list<Class, Bases...>>
         this->last_base = bases + sizeof...(Bases);
         this->is_abstract = std::is_abstract_v<Class>;
         this->static_vptr = &Registry::template static_vptr<Class>;
+        this->is_leaf = &Registry::template is_leaf<Class>;
+
+        using registry_type = typename Registry::registry_type;
+        auto& index = compact_vptr_index<registry_type, Class>;
+
+        if (index == 0) {
+            index = ++compact_vptr_count<registry_type>;
+        }
+
+        this->compact_index = index;
 
         if constexpr (!Registry::has_deferred_static_rtti) {
             resolve_type_ids();
@@ -423,6 +462,17 @@ namespace detail {
 
 void boost_openmethod_vptr(...);
 
+// A v-table pointer standing for an argument, used to resolve a method for a
+// tuple of types, without objects.
+struct vptr_argument {
+    vptr_type vptr;
+};
+
+template<class Registry>
+auto boost_openmethod_vptr(const vptr_argument& arg, Registry*) -> vptr_type {
+    return arg.vptr;
+}
+
 template<typename, class, typename = void>
 struct is_smart_ptr_aux : std::false_type {};
 
@@ -519,6 +569,22 @@ struct is_virtual_ptr_aux<const virtual_ptr<Class, Registry, void>&>
 template<typename T>
 constexpr bool is_virtual_ptr = detail::is_virtual_ptr_aux<T>::value;
 
+// An overrider can take a plain `virtual_ptr` where the method takes a smart
+// `virtual_ptr`. The overrider borrows the object: no smart pointer is created
+// or copied during the call.
+template<typename MethodParameter, typename OverriderParameter>
+constexpr bool is_borrowed_virtual_ptr = false;
+
+template<class T1, class T2, class Registry>
+constexpr bool is_borrowed_virtual_ptr<
+    virtual_ptr<T1, Registry, void>, virtual_ptr<T2, Registry, void>> =
+    IsSmartPtr<T1, Registry> && !IsSmartPtr<T2, Registry>;
+
+template<class T1, class T2, class Registry>
+constexpr bool is_borrowed_virtual_ptr<
+    const virtual_ptr<T1, Registry, void>&, virtual_ptr<T2, Registry, void>> =
+    IsSmartPtr<T1, Registry> && !IsSmartPtr<T2, Registry>;
+
 template<class Class, class Registry>
 constexpr bool has_vptr_fn = std::is_same_v<
     decltype(boost_openmethod_vptr(
@@ -531,7 +597,26 @@ decltype(auto) acquire_vptr(const ArgType& arg) {
 
     if constexpr (detail::has_vptr_fn<ArgType, Registry>) {
         return boost_openmethod_vptr(arg, static_cast<Registry*>(nullptr));
+    } else if constexpr (
+        std::is_final_v<ArgType> && !Registry::has_runtime_checks &&
+        !Registry::has_replication) {
+        // The dynamic type is necessarily the static type.
+        return static_cast<const vptr_type&>(
+            Registry::template static_vptr<ArgType>);
     } else {
+        if constexpr (
+            Registry::has_runtime_checks && !Registry::has_replication &&
+            Registry::rtti::template is_polymorphic<ArgType>) {
+            // Most likely, the dynamic type is the static type. If it is not,
+            // let the vptr policy report the unregistered class.
+            if (Registry::template is_leaf<ArgType> &&
+                Registry::rtti::dynamic_type(arg) ==
+                    Registry::rtti::template static_type<ArgType>()) {
+                return static_cast<const vptr_type&>(
+                    Registry::template static_vptr<ArgType>);
+            }
+        }
+
         return Registry::template policy<policies::vptr>::dynamic_vptr(arg);
     }
 }
@@ -672,6 +757,10 @@ class virtual_ptr {
     friend class virtual_ptr;
     template<class, typename Arg>
     friend auto final_virtual_ptr(Arg&& obj);
+    template<class, class>
+    friend class compact_virtual_ptr;
+    template<class, class>
+    friend class virtual_collection;
 #endif
 
     static constexpr bool is_smart_ptr = false;
@@ -1874,7 +1963,12 @@ struct virtual_traits<virtual_ptr<Class, Registry>, Registry> {
     template<typename Derived>
     static auto
     cast(const virtual_ptr<Class, Registry>& ptr) -> decltype(auto) {
-        return ptr.template cast<typename Derived::element_type>();
+        if constexpr (detail::is_borrowed_virtual_ptr<
+                          virtual_ptr<Class, Registry>, Derived>) {
+            return borrow<typename Derived::element_type>(ptr);
+        } else {
+            return ptr.template cast<typename Derived::element_type>();
+        }
     }
 
     //! Cast to another type.
@@ -1886,7 +1980,25 @@ struct virtual_traits<virtual_ptr<Class, Registry>, Registry> {
     //! to `Derived::element_type`.
     template<typename Derived>
     static auto cast(virtual_ptr<Class, Registry>&& ptr) -> decltype(auto) {
-        return std::move(ptr).template cast<typename Derived::element_type>();
+        if constexpr (detail::is_borrowed_virtual_ptr<
+                          virtual_ptr<Class, Registry>, Derived>) {
+            return borrow<typename Derived::element_type>(ptr);
+        } else {
+            return std::move(ptr)
+                .template cast<typename Derived::element_type>();
+        }
+    }
+
+  private:
+    // Cast a smart `virtual_ptr` to a plain `virtual_ptr`, without copying the
+    // smart pointer.
+    template<class Other>
+    static auto borrow(const virtual_ptr<Class, Registry>& ptr) {
+        using element_type =
+            typename virtual_ptr<Class, Registry>::element_type;
+
+        return virtual_ptr<element_type, Registry>(ptr)
+            .template cast<Other>();
     }
 };
 
@@ -1920,8 +2032,9 @@ struct virtual_traits<const virtual_ptr<Class, Registry>&, Registry> {
     template<typename Derived>
     static auto
     cast(const virtual_ptr<Class, Registry>& ptr) -> decltype(auto) {
-        return ptr.template cast<
-            typename std::remove_reference_t<Derived>::element_type>();
+        return virtual_traits<virtual_ptr<Class, Registry>, Registry>::
+            template cast<std::remove_cv_t<std::remove_reference_t<Derived>>>(
+                ptr);
     }
 };
 
@@ -1955,6 +2068,13 @@ struct select_overrider_virtual_type_aux<
         const virtual_ptr<Q, Registry>&, Registry>::virtual_type;
 };
 
+template<typename P, typename Q, class Registry>
+struct select_overrider_virtual_type_aux<
+    const virtual_ptr<P, Registry>&, virtual_ptr<Q, Registry>, Registry> {
+    using type = typename virtual_traits<
+        virtual_ptr<Q, Registry>, Registry>::virtual_type;
+};
+
 template<typename P, typename Q, class Registry>
 using select_overrider_virtual_type =
     typename select_overrider_virtual_type_aux<P, Q, Registry>::type;
@@ -2060,6 +2180,18 @@ struct validate_method_parameter<
     static_assert(
         false_t<Class, Registry, MethodRegistry>, "registry mismatch");
 };
+
+// The type of the cells in the multi-method dispatch tables.
+template<class Registry, typename = void>
+struct dispatch_cell {
+    using type = word;
+};
+
+template<class Registry>
+struct dispatch_cell<
+    Registry, std::enable_if_t<Registry::has_compact_tables>> {
+    using type = typename Registry::compact_tables::cell_type;
+};
 } // namespace detail
 
 //! Implement a method
@@ -2164,6 +2296,10 @@ class method<Id, ReturnType(Parameters...), Registry>
     : public detail::method_base<Registry> {
     template<auto Function, typename FunctionType>
     struct override_aux;
+    template<class, class>
+    friend class virtual_collection;
+    template<class>
+    friend class routing_table;
 
     // Aliases used in implementation only. Everything extracted from template
     // arguments is capitalized like the arguments themselves.
@@ -2205,6 +2341,28 @@ class method<Id, ReturnType(Parameters...), Registry>
                         StripVirtualDecorator<Parameters>::type... args) const
         -> ReturnType;
 
+    //! Select the overrider for a tuple of types
+    //!
+    //! Return a pointer to the overrider that would be called with virtual
+    //! arguments of the classes designated by `types`, one for each virtual
+    //! parameter, in order. No objects are required. The v-table pointers are
+    //! obtained from the `type_vptr` function of the registry's @ref vptr
+    //! policy, and the dispatch tables are walked as in a call.
+    //!
+    //! The function pointer is valid until the next call to `initialize` or
+    //! `finalize`. If the method is ambiguous or not implemented for the
+    //! types, the function pointer reports the error when it is called.
+    //!
+    //! @par Requirements
+    //!
+    //! The registry's @ref vptr policy must provide a `type_vptr` function.
+    //!
+    //! @tparam TypeIds Types convertible to `type_id`.
+    //! @param types The `type_id`s of registered classes.
+    //! @return A pointer to a function that takes the method's parameters.
+    template<typename... TypeIds>
+    auto resolve_types(TypeIds... types) const -> FunctionPointer;
+
     //! Check if a next most specialized overrider exists
     //!
     //! Return `true` if a next most specialized overrider after _Fn_ exists,
@@ -2277,7 +2435,7 @@ class method<Id, ReturnType(Parameters...), Registry>
 
     type_id vp_type_ids[Arity];
 
-    std::size_t slots_strides[2 * Arity - 1];
+    std::size_t slots_strides[2 * Arity - 1 + Registry::has_compact_tables];
     // Slots followed by strides. No stride for first virtual argument.
     // For 1-method: the offset of the method in the method table, which
     // contains a pointer to a function.
@@ -2285,6 +2443,13 @@ class method<Id, ReturnType(Parameters...), Registry>
     // method table, which contains a pointer to the corresponding cell in
     // the dispatch table, followed by the offset of the second argument and
     // the stride in the second dimension, etc.
+    // For multi-methods dispatched via a decision tree (see sparse_dispatch):
+    // the strides are zero, except for the last virtual argument, which has a
+    // stride of 1.
+    // If the registry has a compact_tables policy: the strides are followed by
+    // the address of the array of function pointers indexed by the cells.
+
+    using cell_type = const typename detail::dispatch_cell<Registry>::type;
 
     void resolve_type_ids();
 
@@ -2304,12 +2469,17 @@ class method<Id, ReturnType(Parameters...), Registry>
         std::size_t VirtualArg, typename MethodArgList, typename ArgType,
         typename... MoreArgTypes>
     auto resolve_multi_next(
-        vptr_type dispatch, const ArgType& arg,
+        cell_type* dispatch, const ArgType& arg,
         const MoreArgTypes&... more_args) const -> detail::word;
 
     template<typename... ArgType>
     FunctionPointer resolve(const ArgType&... args) const;
 
+    template<std::size_t... I>
+    auto resolve_vptrs(
+        const vptr_type (&vptrs)[Arity], std::index_sequence<I...>) const
+        -> FunctionPointer;
+
     template<auto, typename>
     struct thunk;
 
@@ -2469,6 +2639,45 @@ BOOST_FORCEINLINE
     return reinterpret_cast<FunctionPointer>(pf);
 }
 
+template<
+    typename Id, typename... Parameters, typename ReturnType, class Registry>
+template<typename... TypeIds>
+auto method<Id, ReturnType(Parameters...), Registry>::resolve_types(
+    TypeIds... types) const -> FunctionPointer {
+    static_assert(
+        sizeof...(TypeIds) == Arity,
+        "resolve_types requires one type_id per virtual parameter");
+
+    Registry::require_initialized();
+
+    using vptr_policy = typename Registry::template policy<policies::vptr>;
+    const vptr_type vptrs[] = {vptr_policy::type_vptr(types)...};
+
+    return resolve_vptrs(vptrs, std::make_index_sequence<Arity>());
+}
+
+template<
+    typename Id, typename... Parameters, typename ReturnType, class Registry>
+template<std::size_t... I>
+auto method<Id, ReturnType(Parameters...), Registry>::resolve_vptrs(
+    const vptr_type (&vptrs)[Arity], std::index_sequence<I...>) const
+    -> FunctionPointer {
+    using namespace detail;
+
+    // Pass only the virtual arguments, as v-table pointers.
+    using VirtualArgs =
+        mp11::mp_filter<is_virtual, mp11::mp_list<Parameters...>>;
+    void (*pf)();
+
+    if constexpr (Arity == 1) {
+        pf = resolve_uni<VirtualArgs>(vptr_argument{vptrs[I]}...).pf;
+    } else {
+        pf = resolve_multi_first<VirtualArgs>(vptr_argument{vptrs[I]}...).pf;
+    }
+
+    return reinterpret_cast<FunctionPointer>(pf);
+}
+
 template<
     typename Id, typename... Parameters, typename ReturnType, class Registry>
 template<typename ArgType>
@@ -2520,7 +2729,7 @@ method<Id, ReturnType(Parameters...), Registry>::resolve_multi_first(
         // 1, there is no need to store it. Also, the method table
         // contains a pointer into the multi-dimensional dispatch table,
         // already resolved to the appropriate group.
-        auto dispatch = vtbl[slot].pw;
+        auto dispatch = reinterpret_cast<cell_type*>(vtbl[slot].pw);
         return resolve_multi_next<1, mp_rest<MethodArgList>, MoreArgTypes...>(
             dispatch, more_args...);
     } else {
@@ -2536,7 +2745,7 @@ template<
     typename... MoreArgTypes>
 BOOST_FORCEINLINE auto
 method<Id, ReturnType(Parameters...), Registry>::resolve_multi_next(
-    vptr_type dispatch, const ArgType& arg,
+    cell_type* dispatch, const ArgType& arg,
     const MoreArgTypes&... more_args) const -> detail::word {
 
     using namespace detail;
@@ -2546,11 +2755,31 @@ method<Id, ReturnType(Parameters...), Registry>::resolve_multi_next(
         vptr_type vtbl = vptr<ArgType>(arg);
         std::size_t slot = this->slots_strides[VirtualArg];
         std::size_t stride = this->slots_strides[Arity + VirtualArg - 1];
-        dispatch = dispatch + vtbl[slot].i * stride;
+
+        if constexpr (Registry::has_sparse_dispatch && VirtualArg + 1 != Arity) {
+            // A zero stride means that the method uses a decision tree. The
+            // cell contains a pointer to the node for the next argument. Inner
+            // nodes always contain full words, even with compact_tables.
+            if (stride == 0) {
+                auto node = reinterpret_cast<vptr_type>(dispatch);
+                dispatch = reinterpret_cast<cell_type*>(node[vtbl[slot].i].pw);
+            } else {
+                dispatch = dispatch + vtbl[slot].i * stride;
+            }
+        } else {
+            dispatch = dispatch + vtbl[slot].i * stride;
+        }
     }
 
     if constexpr (VirtualArg + 1 == Arity) {
-        return *dispatch;
+        if constexpr (Registry::has_compact_tables) {
+            // The cell contains an index into the method's function pointers.
+            auto functions =
+                reinterpret_cast<vptr_type>(this->slots_strides[2 * Arity - 1]);
+            return functions[*dispatch];
+        } else {
+            return *dispatch;
+        }
     } else {
         return resolve_multi_next<
             VirtualArg + 1, mp_rest<MethodArgList>, MoreArgTypes...>(
@@ -2636,7 +2865,8 @@ struct validate_overrider_parameter<
     T1, T2,
     std::enable_if_t<
         is_virtual_ptr<T1> && is_virtual_ptr<T2> &&
-        !same_reference_category<T1, T2>::value>> : std::false_type {
+        !same_reference_category<T1, T2>::value &&
+        !is_borrowed_virtual_ptr<T1, T2>>> : std::false_type {
     static_assert(
         false_t<T1, T2>, "different virtual_ptr<> reference categories");
 };
@@ -2675,7 +2905,27 @@ struct validate_overrider_parameter<
     using C2 = virtual_type<virtual_ptr<T2, R>, R>;
     static_assert(
         std::is_base_of_v<C1, C2> &&
-            std::is_convertible_v<virtual_ptr<T2, R>, virtual_ptr<T1, R>>,
+            std::is_convertible_v<
+                virtual_ptr<T2, R>,
+                std::conditional_t<
+                    is_borrowed_virtual_ptr<
+                        virtual_ptr<T1, R>, virtual_ptr<T2, R>>,
+                    virtual_ptr<C1, R>, virtual_ptr<T1, R>>>,
+        "method parameter must be an unambiguous accessible base "
+        "of corresponding overrider parameter");
+};
+
+template<class T1, class R, class T2, class R2>
+struct validate_overrider_parameter<
+    const virtual_ptr<T1, R>&, virtual_ptr<T2, R2>,
+    std::enable_if_t<is_borrowed_virtual_ptr<
+        const virtual_ptr<T1, R>&, virtual_ptr<T2, R>>>> : std::true_type {
+    static_assert(std::is_same_v<R, R2>, "registry mismatch");
+    using C1 = virtual_type<const virtual_ptr<T1, R>&, R>;
+    using C2 = virtual_type<virtual_ptr<T2, R>, R>;
+    static_assert(
+        std::is_base_of_v<C1, C2> &&
+            std::is_convertible_v<virtual_ptr<T2, R>, virtual_ptr<C1, R>>,
         "method parameter must be an unambiguous accessible base "
         "of corresponding overrider parameter");
 };
@@ -0,0 +1,111 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_DETAIL_VTBL_CACHE_HPP
+#define BOOST_OPENMETHOD_DETAIL_VTBL_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost::openmethod {
+
+namespace detail {
+
+// Fibonacci hashing: the high bits of the product depend on all the bits of
+// the key, including the low ones, which are often zero in addresses.
+inline auto fibonacci_hash(std::uintptr_t key, std::size_t shift)
+    -> std::size_t {
+    return std::size_t((std::uint64_t(key) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+// A lock-free, insert-only hash table of values keyed by the addresses of C++
+// v-tables, probed linearly. The slots are owned by the caller, and emptied
+// with `clear`, which must not run concurrently with the other functions.
+//
+// A value is written before its key is published, and never changes
+// afterwards. While it is being written, the key holds `busy()`, and readers
+// skip the slot.
+template<typename Value>
+struct vtbl_cache {
+    struct slot {
+        std::atomic<const void*> key{nullptr};
+        Value value{};
+    };
+
+    slot* slots = nullptr;
+    // The table has `mask + 1` slots, a power of two, and `shift` is 64 minus
+    // its number of bits.
+    std::size_t shift = 63;
+    std::size_t mask = 0;
+    // Number of slots probed before giving up.
+    std::size_t probes = 0;
+
+    static auto busy() -> const void* {
+        return reinterpret_cast<const void*>(std::uintptr_t(1));
+    }
+
+    auto index(const void* key) const -> std::size_t {
+        return fibonacci_hash(reinterpret_cast<std::uintptr_t>(key), shift);
+    }
+
+    // Returns a pointer to the value for `key`, or null.
+    auto find(const void* key) const -> const Value* {
+        auto first = index(key);
+
+        for (std::size_t probe = 0; probe < probes; ++probe) {
+            auto& entry = slots[(first + probe) & mask];
+            auto entry_key = entry.key.load(std::memory_order_acquire);
+
+            if (entry_key == key) {
+                return &entry.value;
+            }
+
+            if (!entry_key) {
+                break;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Adds a value for `key`. Returns `true` if this call added it, `false` if
+    // the key was already present or the probed slots are full.
+    auto insert(const void* key, const Value& value) const -> bool {
+        auto first = index(key);
+
+        for (std::size_t probe = 0; probe < probes; ++probe) {
+            auto& entry = slots[(first + probe) & mask];
+            const void* expected = nullptr;
+
+            // Claim an empty slot, write the value, then publish the key.
+            if (entry.key.compare_exchange_strong(
+                    expected, busy(), std::memory_order_acquire)) {
+                entry.value = value;
+                entry.key.store(key, std::memory_order_release);
+
+                return true;
+            }
+
+            if (expected == key) {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    auto clear() const -> void {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].key.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+};
+
+} // namespace detail
+
+} // namespace boost::openmethod
+
+#endif
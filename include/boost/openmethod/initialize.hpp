@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <map>
 #include <memory>
@@ -106,6 +107,12 @@ struct generic_compiler {
         std::size_t mark = 0; // temporary mark to detect cycles
         std::vector<vtbl_entry> vtbl;
         vptr_type* static_vptr;
+        bool* is_leaf;
+        std::uint32_t compact_index = 0;
+        // position of slot 0 relative to the start of the v-table area
+        std::ptrdiff_t vtbl_offset = 0;
+        // class that owns the storage of the v-table, if shared
+        const class_* vtbl_owner = nullptr;
 
         auto is_base_of(class_* other) const -> bool {
             return transitive_derived.find(other) != transitive_derived.end();
@@ -133,6 +140,40 @@ struct generic_compiler {
         std::size_t method_index, spec_index;
     };
 
+    // A v-table word before it is written to the dispatch data. Entries for
+    // the first virtual parameter of multi-methods point into the dispatch
+    // tables, which are not allocated yet; they are stored as offsets.
+    struct vtbl_word {
+        std::uintptr_t value;
+        bool is_table_offset;
+
+        auto operator==(const vtbl_word& other) const -> bool {
+            return value == other.value &&
+                is_table_offset == other.is_table_offset;
+        }
+    };
+
+    static auto share_vtbls(
+        std::deque<class_>& classes,
+        const std::vector<std::vector<vtbl_word>>& contents)
+        -> std::vector<vtbl_word>;
+
+    // A node in a decision tree, used in place of a dispatch table. A node for
+    // dimension `dim` covers the cells that have the same groups in dimensions
+    // 0 to `dim - 1`, and is indexed by the group in dimension `dim`.
+    struct tree_node {
+        // indexes of the nodes for the next dimension...
+        std::vector<std::size_t> children;
+        // ...or overriders, in the last dimension
+        std::vector<const overrider*> overriders;
+        // position of the node, relative to the start of the tree
+        std::size_t offset = 0;
+    };
+
+    static void build_dispatch_tree(
+        method& m, const std::vector<std::size_t>& group_counts,
+        std::size_t cell_size);
+
     using bitvec = boost::dynamic_bitset<>;
 
     struct group {
@@ -146,6 +187,7 @@ struct generic_compiler {
         std::size_t cells = 0;
         std::size_t not_implemented = 0;
         std::size_t ambiguous = 0;
+        std::size_t dropped_cells = 0;
     };
 
     struct report : method_report {};
@@ -165,6 +207,14 @@ struct generic_compiler {
         overrider not_implemented;
         overrider ambiguous;
         vptr_type gv_dispatch_table = nullptr;
+        // if not empty, used in place of dispatch_table
+        std::vector<tree_node> tree;
+        // node in the tree for each group in the first dimension
+        std::vector<std::size_t> tree_roots;
+        // size of the tree, in words
+        std::size_t tree_size = 0;
+        // position of the table in the dispatch data, in words
+        std::size_t table_offset = 0;
         auto arity() const {
             return vp.size();
         }
@@ -400,6 +450,11 @@ struct registry<Policies...>::compiler : detail::generic_compiler {
 
     std::unordered_map<type_index_type, class_*> class_map;
 
+    // Same as `class_map`, but keyed by `type_id`. Depending on the ABI,
+    // hashing and comparing `type_index`es may involve the class names.
+    // Comparing `type_id`s only involves their bits.
+    std::unordered_map<type_id, class_*> class_by_type_id;
+
     using Registry = registry;
 
     compiler(Options... opts);
@@ -408,6 +463,7 @@ struct registry<Policies...>::compiler : detail::generic_compiler {
     void initialize();
     void install_global_tables();
 
+    auto find_class(type_id type) -> class_*;
     void augment_classes();
     void collect_transitive_bases(class_* cls, class_* base);
     void calculate_transitive_derived(class_& cls);
@@ -421,6 +477,12 @@ struct registry<Policies...>::compiler : detail::generic_compiler {
         std::vector<group_map>::const_iterator group, const bitvec& candidates,
         bool concrete);
     void write_global_data();
+    void replicate(
+        const detail::word* first, std::size_t size,
+        const std::vector<std::size_t>& relocations);
+    static auto write_cells(
+        detail::word* first, const std::vector<const overrider*>& specs,
+        detail::word* last) -> detail::word*;
     void print(const method_report& report) const;
     static void select_dominant_overriders(
         std::vector<overrider*>& dominants, std::size_t& pick,
@@ -437,6 +499,26 @@ struct registry<Policies...>::compiler : detail::generic_compiler {
 
     static constexpr bool has_trace = has_option<trace>;
     static constexpr bool has_n2216 = has_option<n2216>;
+    static constexpr bool has_concrete_only = has_option<concrete_only>;
+    static constexpr bool has_arena = has_option<arena>;
+
+    // Alignment of the parts of the arena, in words.
+    static constexpr std::size_t cache_line_words = 64 / sizeof(detail::word);
+
+    static constexpr auto cache_line_align(std::size_t words) -> std::size_t {
+        return (words + cache_line_words - 1) / cache_line_words *
+            cache_line_words;
+    }
+
+    // Size of a dispatch table cell, in bytes.
+    static constexpr std::size_t cell_size =
+        sizeof(typename detail::dispatch_cell<registry>::type);
+
+    // Number of words occupied by `cells` cells.
+    static constexpr auto cell_words(std::size_t cells) -> std::size_t {
+        return (cells * cell_size + sizeof(detail::word) - 1) /
+            sizeof(detail::word);
+    }
 
     mutable detail::trace_stream<compiler> tr;
     using indent = typename detail::trace_stream<compiler>::indent;
@@ -530,6 +612,29 @@ void registry<Policies...>::compiler<Options...>::collect_transitive_bases(
     }
 }
 
+template<class... Policies>
+template<class... Options>
+auto registry<Policies...>::compiler<Options...>::find_class(type_id type)
+    -> class_* {
+    auto iter = class_by_type_id.find(type);
+
+    if (iter != class_by_type_id.end()) {
+        return iter->second;
+    }
+
+    // Not one of the type_ids the classes were registered with, but it may
+    // designate the same class, e.g. if it comes from another shared library.
+    auto index_iter = class_map.find(rtti::type_index(type));
+
+    if (index_iter == class_map.end()) {
+        return nullptr;
+    }
+
+    class_by_type_id.emplace(type, index_iter->second);
+
+    return index_iter->second;
+}
+
 template<class... Policies>
 template<class... Options>
 void registry<Policies...>::compiler<Options...>::augment_classes() {
@@ -559,6 +664,8 @@ void registry<Policies...>::compiler<Options...>::augment_classes() {
                 rtc = &classes.emplace_back();
                 rtc->is_abstract = cr.is_abstract;
                 rtc->static_vptr = cr.static_vptr;
+                rtc->is_leaf = cr.is_leaf;
+                rtc->compact_index = cr.compact_index;
             }
 
             if (std::find(
@@ -566,6 +673,8 @@ void registry<Policies...>::compiler<Options...>::augment_classes() {
                 rtc->type_ids.end()) {
                 rtc->type_ids.push_back(cr.type);
             }
+
+            class_by_type_id.emplace(cr.type, rtc);
         }
     }
 
@@ -573,10 +682,10 @@ void registry<Policies...>::compiler<Options...>::augment_classes() {
     // map. Collect the bases.
 
     for (auto& cr : registry::classes) {
-        auto rtc = class_map[rtti::type_index(cr.type)];
+        auto rtc = class_by_type_id[cr.type];
 
         for (auto& base : range{cr.first_base, cr.last_base}) {
-            auto rtb = class_map[rtti::type_index(base)];
+            auto rtb = find_class(base);
 
             if (!rtb) {
                 missing_class error;
@@ -726,7 +835,7 @@ void registry<Policies...>::compiler<Options...>::augment_methods() {
             std::size_t param_index = 0;
 
             for (auto ti : range{meth_info.vp_begin, meth_info.vp_end}) {
-                auto class_ = class_map[rtti::type_index(ti)];
+                auto class_ = find_class(ti);
                 if (!class_) {
                     ++tr << "unknown class " << ti << "(" << type_name(ti)
                          << ") for parameter #" << (param_index + 1) << "\n";
@@ -746,13 +855,8 @@ void registry<Policies...>::compiler<Options...>::augment_methods() {
 
         if (rtti::type_index(meth_info.return_type_id) !=
             rtti::type_index(rtti::template static_type<void>())) {
-            auto covariant_return_iter =
-                class_map.find(rtti::type_index(meth_info.return_type_id));
-
-            if (covariant_return_iter != class_map.end()) {
-                meth_iter->covariant_return_type =
-                    covariant_return_iter->second;
-            }
+            meth_iter->covariant_return_type =
+                find_class(meth_info.return_type_id);
         }
 
         // initialize the function pointer in the synthetic not_implemented
@@ -787,7 +891,7 @@ void registry<Policies...>::compiler<Options...>::augment_methods() {
             for (auto type :
                  range{overrider_info.vp_begin, overrider_info.vp_end}) {
                 indent _(tr);
-                auto class_ = class_map[rtti::type_index(type)];
+                auto class_ = find_class(type);
 
                 if (!class_) {
                     ++tr << "unknown class error for *virtual* parameter #"
@@ -807,13 +911,10 @@ void registry<Policies...>::compiler<Options...>::augment_methods() {
             }
 
             if (meth_iter->covariant_return_type) {
-                auto covariant_return_iter = class_map.find(
-                    rtti::type_index(overrider_info.return_type));
+                spec_iter->covariant_return_type =
+                    find_class(overrider_info.return_type);
 
-                if (covariant_return_iter != class_map.end()) {
-                    spec_iter->covariant_return_type =
-                        covariant_return_iter->second;
-                } else {
+                if (!spec_iter->covariant_return_type) {
                     missing_class error;
                     error.type = overrider_info.return_type;
 
@@ -1061,6 +1162,52 @@ void registry<Policies...>::compiler<Options...>::build_dispatch_tables() {
             }
         }
 
+        // uni-methods do not have dispatch tables
+        if (has_concrete_only && m.arity() > 1) {
+            std::size_t all_cells = 1, concrete_cells = 1;
+
+            for (auto& dim_groups : groups) {
+                all_cells *= dim_groups.size();
+                std::vector<class_*> abstract_classes;
+
+                for (auto iter = dim_groups.begin();
+                     iter != dim_groups.end();) {
+                    if (iter->second.has_concrete_classes) {
+                        ++iter;
+                    } else {
+                        ++tr << "drop abstract group " << iter->first << " "
+                             << iter->second.classes << "\n";
+                        abstract_classes.insert(
+                            abstract_classes.end(),
+                            iter->second.classes.begin(),
+                            iter->second.classes.end());
+                        iter = dim_groups.erase(iter);
+                    }
+                }
+
+                if (!abstract_classes.empty()) {
+                    group* target;
+
+                    if (has_runtime_checks || dim_groups.empty()) {
+                        // A group without overriders, which dispatches to
+                        // the "not implemented" handler. If there is already
+                        // one, it contains concrete classes.
+                        target = &dim_groups[bitvec(m.overriders.size())];
+                    } else {
+                        target = &dim_groups.begin()->second;
+                    }
+
+                    target->classes.insert(
+                        target->classes.end(), abstract_classes.begin(),
+                        abstract_classes.end());
+                }
+
+                concrete_cells *= dim_groups.size();
+            }
+
+            m.report.dropped_cells = all_cells - concrete_cells;
+        }
+
         {
             std::size_t stride = 1;
             m.strides.reserve(dims - 1);
@@ -1125,6 +1272,40 @@ void registry<Policies...>::compiler<Options...>::build_dispatch_tables() {
                 }
 
                 tr << "\n";
+
+                if constexpr (has_sparse_dispatch) {
+                    if (m.report.cells > sparse_dispatch::threshold) {
+                        std::vector<std::size_t> group_counts;
+                        group_counts.reserve(dims);
+
+                        for (const auto& dim_groups : groups) {
+                            group_counts.push_back(dim_groups.size());
+                        }
+
+                        build_dispatch_tree(m, group_counts, cell_size);
+
+                        ++tr << "decision tree: " << m.tree.size() << " nodes, "
+                             << m.tree_size << " words";
+
+                        auto table_words = cell_words(m.dispatch_table.size());
+
+                        if (m.tree_size < table_words) {
+                            tr << ", saves " << (table_words - m.tree_size)
+                               << " words\n";
+                        } else {
+                            tr << ", not smaller than the table\n";
+                            m.tree.clear();
+                            m.tree_roots.clear();
+                            m.tree_size = 0;
+                        }
+                    }
+                }
+            }
+
+            if (m.report.dropped_cells) {
+                indent _(tr);
+                ++tr << "abstract classes removed: saves "
+                     << m.report.dropped_cells << " cells\n";
             }
 
             print(m.report);
@@ -1146,6 +1327,8 @@ void registry<Policies...>::compiler<Options...>::build_dispatch_table(
 
     for (const auto& [group_mask, group] : *group_iter) {
         auto mask = candidates & group_mask;
+        [[maybe_unused]] auto counted = !has_concrete_only ||
+            (concrete && group.has_concrete_classes);
 
         if constexpr (has_trace) {
             ++tr << "group " << dim << "/" << group_index << " mask " << mask
@@ -1186,13 +1369,13 @@ void registry<Policies...>::compiler<Options...>::build_dispatch_table(
                 indent _(tr);
                 ++tr << "not implemented\n";
                 m.dispatch_table.push_back(&m.not_implemented);
-                ++m.report.not_implemented;
+                m.report.not_implemented += counted;
             } else {
                 if constexpr (!has_option<n2216>) {
                     if (remaining > 1) {
                         ++tr << "ambiguous\n";
                         m.dispatch_table.push_back(&m.ambiguous);
-                        ++m.report.ambiguous;
+                        m.report.ambiguous += counted;
                         continue;
                     }
                 }
@@ -1207,7 +1390,7 @@ void registry<Policies...>::compiler<Options...>::build_dispatch_table(
 
                 if (remaining > 1) {
                     tr << " (ambiguous)";
-                    ++m.report.ambiguous;
+                    m.report.ambiguous += counted;
                 }
 
                 tr << "\n";
@@ -1287,6 +1470,229 @@ inline void detail::generic_compiler::accumulate(
     total.cells += partial.cells;
     total.not_implemented += partial.not_implemented != 0;
     total.ambiguous += partial.ambiguous != 0;
+    total.dropped_cells += partial.dropped_cells;
+}
+
+inline void detail::generic_compiler::build_dispatch_tree(
+    method& m, const std::vector<std::size_t>& group_counts,
+    std::size_t cell_size) {
+    // Build the nodes bottom-up, from the last dimension to the second,
+    // sharing identical nodes. Inner nodes contain words; leaves contain cells
+    // of `cell_size` bytes, padded to a whole number of words. The nodes for
+    // dimension `dim` are identified by the index of their first cell in the
+    // dispatch table, which is smaller than the stride for that dimension.
+    auto last_dim = m.arity() - 1;
+    std::vector<std::size_t> next_nodes;
+
+    m.tree.clear();
+
+    for (auto dim = last_dim; dim > 0; --dim) {
+        auto stride = m.strides[dim - 1];
+        std::vector<std::size_t> nodes(stride);
+        std::map<std::vector<std::size_t>, std::size_t> interned_nodes;
+        std::map<std::vector<const overrider*>, std::size_t> interned_leaves;
+
+        for (std::size_t first_cell = 0; first_cell < stride; ++first_cell) {
+            tree_node node;
+            std::size_t index = m.tree.size();
+
+            if (dim == last_dim) {
+                node.overriders.reserve(group_counts[dim]);
+
+                for (std::size_t group = 0; group < group_counts[dim];
+                     ++group) {
+                    node.overriders.push_back(
+                        m.dispatch_table[first_cell + group * stride]);
+                }
+
+                index =
+                    interned_leaves.try_emplace(node.overriders, index)
+                        .first->second;
+            } else {
+                node.children.reserve(group_counts[dim]);
+
+                for (std::size_t group = 0; group < group_counts[dim];
+                     ++group) {
+                    node.children.push_back(
+                        next_nodes[first_cell + group * stride]);
+                }
+
+                index = interned_nodes.try_emplace(node.children, index)
+                            .first->second;
+            }
+
+            if (index == m.tree.size()) {
+                m.tree.push_back(std::move(node));
+            }
+
+            nodes[first_cell] = index;
+        }
+
+        next_nodes.swap(nodes);
+    }
+
+    m.tree_roots = std::move(next_nodes);
+    m.tree_size = 0;
+
+    for (auto& node : m.tree) {
+        node.offset = m.tree_size;
+        m.tree_size += node.children.size() +
+            (node.overriders.size() * cell_size + sizeof(word) - 1) /
+                sizeof(word);
+    }
+}
+
+inline auto detail::generic_compiler::share_vtbls(
+    std::deque<class_>& classes,
+    const std::vector<std::vector<vtbl_word>>& contents)
+    -> std::vector<vtbl_word> {
+    // Lay out the v-tables, largest first. A v-table that matches a prefix or a
+    // suffix of a v-table already laid out, for the same slots, shares its
+    // storage. Candidates are found via a polynomial hash of the first slot and
+    // the words, then compared.
+    struct candidate {
+        std::ptrdiff_t vtbl_offset;
+        std::size_t first_slot, size;
+        const class_* owner;
+    };
+
+    constexpr std::uint64_t factor = 0x100000001b3;
+
+    auto word_hash = [](const vtbl_word& word) {
+        return std::uint64_t(word.value) * 2 + word.is_table_offset;
+    };
+
+    std::vector<std::size_t> order(classes.size());
+    std::iota(order.begin(), order.end(), std::size_t(0));
+    std::stable_sort(
+        order.begin(), order.end(), [&contents](std::size_t a, std::size_t b) {
+            return contents[a].size() > contents[b].size();
+        });
+
+    std::vector<vtbl_word> words;
+    std::unordered_multimap<std::uint64_t, candidate> candidates;
+
+    for (auto index : order) {
+        auto& cls = classes[index];
+        auto& content = contents[index];
+        auto first_slot = static_cast<std::ptrdiff_t>(cls.first_slot);
+
+        if (content.empty()) {
+            cls.vtbl_offset = std::ptrdiff_t(words.size()) - first_slot;
+            continue;
+        }
+
+        std::uint64_t hash = cls.first_slot;
+
+        for (auto& word : content) {
+            hash = hash * factor + word_hash(word);
+        }
+
+        auto [iter, last] = candidates.equal_range(hash);
+
+        for (; iter != last; ++iter) {
+            auto& cand = iter->second;
+
+            if (cand.first_slot == cls.first_slot &&
+                cand.size == content.size() &&
+                std::equal(
+                    content.begin(), content.end(),
+                    words.begin() + cand.vtbl_offset + first_slot)) {
+                break;
+            }
+        }
+
+        if (iter != last) {
+            cls.vtbl_offset = iter->second.vtbl_offset;
+            cls.vtbl_owner = iter->second.owner;
+            continue;
+        }
+
+        auto size = content.size();
+        cls.vtbl_offset = std::ptrdiff_t(words.size()) - first_slot;
+        words.insert(words.end(), content.begin(), content.end());
+
+        // register the prefixes...
+        hash = cls.first_slot;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = hash * factor + word_hash(content[i]);
+            candidates.emplace(
+                hash,
+                candidate{cls.vtbl_offset, cls.first_slot, i + 1, &cls});
+        }
+
+        // ...and the proper suffixes
+        std::uint64_t sum = 0, power = 1;
+
+        for (auto i = size; i-- > 1;) {
+            sum += word_hash(content[i]) * power;
+            power *= factor;
+            auto suffix_first_slot = cls.first_slot + i;
+            candidates.emplace(
+                suffix_first_slot * power + sum,
+                candidate{
+                    cls.vtbl_offset, suffix_first_slot, size - i, &cls});
+        }
+    }
+
+    return words;
+}
+
+template<class... Policies>
+template<class... Options>
+auto registry<Policies...>::compiler<Options...>::write_cells(
+    detail::word* first, const std::vector<const overrider*>& specs,
+    [[maybe_unused]] detail::word* last) -> detail::word* {
+    // Store the index of each overrider in a narrow cell, and pad to a whole
+    // number of words.
+    using cell_type = typename detail::dispatch_cell<registry>::type;
+
+    BOOST_ASSERT(first + cell_words(specs.size()) <= last);
+    auto bytes = reinterpret_cast<unsigned char*>(first);
+
+    for (auto spec : specs) {
+        auto cell = static_cast<cell_type>(spec->spec_index);
+        std::memcpy(bytes, &cell, sizeof(cell));
+        bytes += sizeof(cell);
+    }
+
+    return first + cell_words(specs.size());
+}
+
+template<class... Policies>
+template<class... Options>
+void registry<Policies...>::compiler<Options...>::replicate(
+    const detail::word* first, std::size_t size,
+    const std::vector<std::size_t>& relocations) {
+    using state = detail::replication_state<registry>;
+
+    state::release();
+    auto replicas = replication::initialize();
+    state::offsets.push_back(0);
+    auto bytes = size * sizeof(detail::word);
+
+    ++tr << "Replicating " << bytes << " bytes of dispatch data "
+         << (replicas - 1) << " time(s)\n";
+
+    for (std::size_t replica = 1; replica < replicas; ++replica) {
+        auto copy =
+            static_cast<detail::word*>(replication::allocate(replica, bytes));
+        std::memcpy(copy, first, bytes);
+        auto offset = reinterpret_cast<char*>(copy) -
+            reinterpret_cast<const char*>(first);
+
+        for (auto pos : relocations) {
+            copy[pos].pw = reinterpret_cast<detail::word*>(
+                reinterpret_cast<char*>(copy[pos].pw) + offset);
+        }
+
+        state::copies.emplace_back(copy, bytes);
+        state::offsets.push_back(offset);
+
+        indent _(tr);
+        ++tr << "replica " << replica << " at " << copy << "\n";
+    }
 }
 
 template<class... Policies>
@@ -1295,20 +1701,128 @@ void registry<Policies...>::compiler<Options...>::write_global_data() {
     using namespace policies;
     using namespace detail;
 
-    auto dispatch_data_size = std::accumulate(
-        methods.begin(), methods.end(), std::size_t(0),
-        [](std::size_t sum, const method& m) {
-            // msvc doesn't like (auto sum, auto& m) (C2187), go figure...
-            return sum + m.dispatch_table.size();
-        });
-    dispatch_data_size = std::accumulate(
-        classes.begin(), classes.end(), dispatch_data_size,
-        [](auto sum, const auto& cls) { return sum + cls.vtbl.size(); });
+    std::size_t tables_size = 0;
+
+    for (auto& m : methods) {
+        if (m.arity() == 1) {
+            continue;
+        }
+
+        if constexpr (has_compact_tables) {
+            // The table is preceded by the function pointers that its cells
+            // index: the overriders, then not_implemented and ambiguous.
+            auto functions = m.overriders.size() + 2;
+            compact_tables::check(m.info->method_type_id, functions);
+            tables_size += functions;
+        }
+
+        m.table_offset = tables_size;
+
+        if (!m.tree.empty()) {
+            tables_size += m.tree_size;
+        } else {
+            tables_size += cell_words(m.dispatch_table.size());
+        }
+    }
+
+    std::vector<std::vector<vtbl_word>> vtbl_contents;
+    vtbl_contents.reserve(classes.size());
+
+    for (auto& cls : classes) {
+        auto& content = vtbl_contents.emplace_back();
+        content.reserve(cls.vtbl.size());
+
+        for (auto& entry : cls.vtbl) {
+            auto& method = methods[entry.method_index];
+
+            if (method.arity() == 1) {
+                content.push_back(
+                    {reinterpret_cast<std::uintptr_t>(
+                         method.dispatch_table[entry.group_index]->pf),
+                     false});
+            } else if (entry.vp_index == 0) {
+                // Offsets are in bytes, because cells may be narrower than
+                // words.
+                auto offset = entry.group_index * cell_size;
+
+                if (!method.tree.empty()) {
+                    offset =
+                        method.tree[method.tree_roots[entry.group_index]]
+                            .offset *
+                        sizeof(word);
+                }
+
+                content.push_back(
+                    {method.table_offset * sizeof(word) + offset, true});
+            } else {
+                content.push_back({entry.group_index, false});
+            }
+        }
+    }
 
-    std::vector<detail::word> new_dispatch_data(dispatch_data_size);
+    // With a vtbl_storage policy, the v-tables are placed by the policy,
+    // after the dispatch tables.
+    std::vector<vtbl_word> vtbl_words;
+
+    if constexpr (!has_vtbl_storage) {
+        vtbl_words = share_vtbls(classes, vtbl_contents);
+    }
+
+    // By default, the dispatch tables are followed by the v-tables. With the
+    // `arena` option, the vptr index comes first, then the v-tables, then the
+    // dispatch tables, each part starting on a cache line.
+    using arena_state = detail::arena_state<registry>;
+    std::size_t index_size = 0;
+    std::size_t vtbls_offset = tables_size;
+    std::size_t tables_offset = 0;
+    std::size_t dispatch_data_size = tables_size + vtbl_words.size();
+    std::size_t padding = 0;
+
+    if constexpr (has_arena) {
+        if constexpr (has_vptr) {
+            // Measure the memory that the vptr policy allocates via
+            // arena_allocator.
+            auto on = tr.on;
+            tr.on = false;
+
+            {
+                typename arena_state::pass pass;
+                arena_state::measuring = true;
+                arena_state::requested = 0;
+                vptr::initialize(*this, options);
+            }
+
+            tr.on = on;
+            index_size = cache_line_align(
+                (arena_state::requested + sizeof(word) - 1) / sizeof(word));
+        }
+
+        vtbls_offset = index_size;
+        tables_offset = vtbls_offset + cache_line_align(vtbl_words.size());
+        dispatch_data_size = tables_offset + tables_size;
+        padding = cache_line_words - 1;
+    }
+
+    decltype(dispatch_data) new_dispatch_data(dispatch_data_size + padding);
     auto gv_first = new_dispatch_data.data();
+
+    if constexpr (has_arena) {
+        auto misalignment =
+            reinterpret_cast<std::uintptr_t>(gv_first) % 64 / sizeof(word);
+        gv_first += misalignment ? cache_line_words - misalignment : 0;
+
+        ++tr << "Arena at " << gv_first << ": index " << index_size
+             << " words, v-tables at " << vtbls_offset << ", tables at "
+             << tables_offset << ", " << dispatch_data_size << " words\n";
+    }
+
     [[maybe_unused]] auto gv_last = gv_first + dispatch_data_size;
-    auto gv_iter = gv_first;
+    auto gv_tables = gv_first + tables_offset;
+    auto gv_iter = gv_tables;
+
+    // Positions of the words that point into the dispatch data, adjusted in
+    // the replicas.
+    [[maybe_unused]] std::vector<std::size_t> relocations;
 
     ++tr << "Initializing multi-method dispatch tables at " << gv_iter << "\n";
 
@@ -1319,6 +1833,56 @@ void registry<Policies...>::compiler<Options...>::write_global_data() {
         } else {
             auto strides_iter = std::copy(
                 m.slots.begin(), m.slots.end(), m.info->slots_strides_ptr);
+
+            if constexpr (has_compact_tables) {
+                BOOST_ASSERT(gv_iter + m.overriders.size() + 2 <= gv_last);
+                m.info->slots_strides_ptr[2 * m.arity() - 1] =
+                    reinterpret_cast<std::uintptr_t>(gv_iter);
+
+                for (auto& overrider : m.overriders) {
+                    *gv_iter++ = overrider.pf;
+                }
+
+                *gv_iter++ = m.not_implemented.pf;
+                *gv_iter++ = m.ambiguous.pf;
+            }
+
+            BOOST_ASSERT(gv_iter == gv_tables + m.table_offset);
+
+            if (!m.tree.empty()) {
+                std::fill_n(strides_iter, m.strides.size() - 1, 0);
+                strides_iter[m.strides.size() - 1] = 1;
+
+                ++tr << rflush(4, gv_iter - gv_first) << " " << " method #"
+                     << m.dispatch_table[0]->method_index << " "
+                     << type_name(m.info->method_type_id) << " (tree)\n";
+
+                auto tree_first = gv_iter;
+                m.gv_dispatch_table = gv_iter;
+                BOOST_ASSERT(gv_iter + m.tree_size <= gv_last);
+
+                for (auto& node : m.tree) {
+                    for (auto child : node.children) {
+                        if constexpr (has_replication) {
+                            relocations.push_back(gv_iter - gv_first);
+                        }
+
+                        *gv_iter++ = tree_first + m.tree[child].offset;
+                    }
+
+                    if constexpr (has_compact_tables) {
+                        gv_iter =
+                            write_cells(gv_iter, node.overriders, gv_last);
+                    } else {
+                        for (auto spec : node.overriders) {
+                            *gv_iter++ = spec->pf;
+                        }
+                    }
+                }
+
+                continue;
+            }
+
             std::copy(m.strides.begin(), m.strides.end(), strides_iter);
 
             if constexpr (has_trace) {
@@ -1334,10 +1898,15 @@ void registry<Policies...>::compiler<Options...>::write_global_data() {
             }
 
             m.gv_dispatch_table = gv_iter;
-            BOOST_ASSERT(gv_iter + m.dispatch_table.size() <= gv_last);
-            gv_iter = std::transform(
-                m.dispatch_table.begin(), m.dispatch_table.end(), gv_iter,
-                [](auto spec) { return spec->pf; });
+
+            if constexpr (has_compact_tables) {
+                gv_iter = write_cells(gv_iter, m.dispatch_table, gv_last);
+            } else {
+                BOOST_ASSERT(gv_iter + m.dispatch_table.size() <= gv_last);
+                gv_iter = std::transform(
+                    m.dispatch_table.begin(), m.dispatch_table.end(), gv_iter,
+                    [](auto spec) { return spec->pf; });
+            }
         }
     }
 
@@ -1364,54 +1933,169 @@ void registry<Policies...>::compiler<Options...>::write_global_data() {
         }
     }
 
+    auto vtbl_first = gv_first + vtbls_offset;
+    gv_iter = vtbl_first;
+    BOOST_ASSERT(gv_iter + vtbl_words.size() <= gv_last);
+
     ++tr << "Initializing v-tables at " << gv_iter << "\n";
 
-    for (auto& cls : classes) {
-        *cls.static_vptr = gv_iter - cls.first_slot;
+    for (auto& word : vtbl_words) {
+        if (word.is_table_offset) {
+            if constexpr (has_replication) {
+                relocations.push_back(gv_iter - gv_first);
+            }
 
-        ++tr << rflush(4, gv_iter - gv_first) << " " << gv_iter << " vtbl for "
-             << cls << " slots " << cls.first_slot << "-"
-             << (cls.first_slot + cls.vtbl.size() - 1) << "\n";
-        indent _(tr);
+            *gv_iter++ = reinterpret_cast<std::uintptr_t>(
+                reinterpret_cast<char*>(gv_tables) + word.value);
+        } else {
+            *gv_iter++ = word.value;
+        }
+    }
 
-        for (auto& entry : cls.vtbl) {
-            ++tr << "method #" << entry.method_index << " ";
-            auto& method = methods[entry.method_index];
+    if constexpr (has_vtbl_storage) {
+        std::vector<vtbl_placement> placements;
+        placements.reserve(classes.size());
 
-            if (method.arity() == 1) {
-                auto spec = method.dispatch_table[entry.group_index];
-                tr << "spec #" << spec->spec_index << "\n";
-                indent _(tr);
-                ++tr << type_name(method.info->method_type_id) << "\n";
-                ++tr << spec_name(method, spec);
-                BOOST_ASSERT(gv_iter + 1 <= gv_last);
-                *gv_iter++ = spec->pf;
-            } else {
-                tr << "vp #" << entry.vp_index << " group #"
-                   << entry.group_index << "\n";
-                indent _2(tr);
-                ++tr << type_name(method.info->method_type_id);
-                BOOST_ASSERT(gv_iter + 1 <= gv_last);
-
-                if (entry.vp_index == 0) {
-                    *gv_iter++ = std::uintptr_t(
-                        method.gv_dispatch_table + entry.group_index);
+        for (auto& cls : classes) {
+            placements.push_back(
+                {cls.static_vptr, cls.type_ids[0], cls.first_slot,
+                 cls.vtbl.size(), nullptr});
+        }
+
+        vtbl_storage::place(
+            placements.data(), placements.data() + placements.size());
+
+        auto placement = placements.begin();
+        auto content = vtbl_contents.begin();
+
+        for (auto& cls : classes) {
+            auto vtbl_iter = placement->vptr + cls.first_slot;
+
+            for (auto& word : *content) {
+                if (word.is_table_offset) {
+                    *vtbl_iter++ = reinterpret_cast<std::uintptr_t>(
+                        reinterpret_cast<char*>(gv_tables) + word.value);
                 } else {
-                    *gv_iter++ = entry.group_index;
+                    *vtbl_iter++ = word.value;
                 }
             }
 
+            *cls.static_vptr = placement->vptr;
+            ++placement;
+            ++content;
+        }
+    }
+
+    std::size_t shared = 0;
+    auto use_compact_vptrs = detail::compact_vptrs_used<registry>;
+    decltype(detail::compact_vptrs<registry>) compact_vptrs;
+    decltype(detail::compact_type_indexes<registry>) compact_type_indexes;
+
+    if (use_compact_vptrs) {
+        compact_vptrs.resize(detail::compact_vptr_count<registry> + 1);
+
+        if constexpr (has_indirect_vptr) {
+            compact_vptrs[0] = &detail::null_vptr;
+        }
+
+        compact_type_indexes.reserve(class_by_type_id.size());
+
+        for (auto& entry : class_by_type_id) {
+            compact_type_indexes.emplace_back(
+                entry.first, entry.second->compact_index);
+        }
+
+        std::sort(
+            compact_type_indexes.begin(), compact_type_indexes.end(),
+            [](const auto& a, const auto& b) {
+                return std::less<type_id>()(a.first, b.first);
+            });
+    }
+
+    for (auto& cls : classes) {
+        if constexpr (!has_vtbl_storage) {
+            *cls.static_vptr = vtbl_first + cls.vtbl_offset;
+        }
+
+        *cls.is_leaf = cls.direct_derived.empty();
+
+        if (use_compact_vptrs) {
+            if constexpr (has_indirect_vptr) {
+                compact_vptrs[cls.compact_index] = cls.static_vptr;
+            } else {
+                compact_vptrs[cls.compact_index] = *cls.static_vptr;
+            }
+        }
+
+        shared += cls.vtbl_owner != nullptr;
+
+        if constexpr (has_trace) {
+            auto vtbl = *cls.static_vptr + cls.first_slot;
+            ++tr << rflush(4, vtbl - gv_first) << " " << vtbl << " vtbl for "
+                 << cls << " slots " << cls.first_slot << "-"
+                 << (cls.first_slot + cls.vtbl.size() - 1);
+
+            if (cls.vtbl_owner) {
+                tr << " shared with " << *cls.vtbl_owner;
+            }
+
             tr << "\n";
+            indent _(tr);
+
+            for (auto& entry : cls.vtbl) {
+                ++tr << "method #" << entry.method_index << " ";
+                auto& method = methods[entry.method_index];
+
+                if (method.arity() == 1) {
+                    auto spec = method.dispatch_table[entry.group_index];
+                    tr << "spec #" << spec->spec_index << "\n";
+                    indent _(tr);
+                    ++tr << type_name(method.info->method_type_id) << "\n";
+                    ++tr << spec_name(method, spec);
+                } else {
+                    tr << "vp #" << entry.vp_index << " group #"
+                       << entry.group_index << "\n";
+                    indent _2(tr);
+                    ++tr << type_name(method.info->method_type_id);
+                }
+
+                tr << "\n";
+            }
         }
     }
 
-    ++tr << rflush(4, dispatch_data_size) << " " << gv_iter << " end\n";
+    ++tr << rflush(4, dispatch_data_size) << " " << gv_iter << " end, "
+         << shared << " shared v-tables\n";
+
+    if constexpr (has_replication) {
+        replicate(gv_first, dispatch_data_size, relocations);
+    }
 
     if constexpr (has_vptr) {
+        typename arena_state::pass pass;
+
+        if constexpr (has_arena) {
+            // Serve the next arena_allocator allocation from the front of
+            // the arena.
+            arena_state::first = index_size ? gv_first : nullptr;
+            arena_state::size = index_size * sizeof(word);
+            arena_state::next = {gv_first, gv_first + index_size};
+            arena_state::measured = true;
+        }
+
         vptr::initialize(*this, options);
     }
 
     new_dispatch_data.swap(dispatch_data);
+
+    if constexpr (has_arena) {
+        arena_state::current = {gv_first, gv_first + index_size};
+    } else {
+        arena_state::current = {nullptr, nullptr};
+    }
+
+    compact_vptrs.swap(detail::compact_vptrs<registry>);
+    compact_type_indexes.swap(detail::compact_type_indexes<registry>);
 }
 
 template<class... Policies>
@@ -1539,7 +2223,13 @@ void registry<Policies...>::compiler<Options...>::print(
     }
 
     tr << r.not_implemented << " not implemented, " << r.ambiguous
-       << " ambiguous\n";
+       << " ambiguous";
+
+    if (r.dropped_cells) {
+        tr << ", " << r.dropped_cells << " abstract cells dropped";
+    }
+
+    tr << "\n";
 }
 
 //! Initialize a registry.
@@ -1548,10 +2238,21 @@ void registry<Policies...>::compiler<Options...>::print(
 //! argument, or @ref default_registry if the registry is not specified. The
 //! default can be changed by defining {{BOOST_OPENMETHOD_DEFAULT_REGISTRY}}.
 //! Option objects can be passed to change the behavior of the function.
-//! Currently two options exist:
+//! Currently six options exist:
 //! @li @ref trace Enable tracing of the initialization process.
 //! @li @ref n2216 Enable resolution of ambiguities according to the N2216
 //! paper.
+//! @li @ref concrete_only Remove the abstract classes from the multi-method
+//! dispatch tables.
+//! @li @ref arena Place the registry's runtime data in a single, cache-line
+//! aligned block of memory.
+//! @li @ref parallel_hash_search Search for hash factors on several threads.
+//! @li @ref hash_multiplier Try a known hash factor before searching.
+//!
+//! The last two are defined in
+//! `<boost/openmethod/policies/parallel_hash_search.hpp>` and
+//! `<boost/openmethod/policies/fast_perfect_hash.hpp>` respectively, and only
+//! affect the @ref policies::fast_perfect_hash policy.
 //!
 //! `initialize` must be called, typically at the beginning of `main`, before
 //! using any of the methods in a registry. It sets up the v-tables,
@@ -1566,6 +2267,8 @@ void registry<Policies...>::compiler<Options...>::print(
 //! contain at least one not implemented entry.
 //! @li `std::size_t ambiguous`: The number of multi-method dispatch tables that contain at
 //! least one ambiguous entry.
+//! @li `std::size_t dropped_cells`: The number of cells removed from the
+//! multi-method dispatch tables by the @ref concrete_only option.
 //!
 //! @note
 //! A translation unit that calls `initialize` must include the
@@ -1621,7 +2324,9 @@ inline auto initialize(Options&&... options) {
         std::abort();
     }
 
-    typename Registry::template compiler<Options...> comp(
+    // Options passed as lvalues are copied, so that the compiler and the
+    // policies can detect them by type.
+    typename Registry::template compiler<std::decay_t<Options>...> comp(
         std::forward<Options>(options)...);
     comp.initialize();
 
@@ -1652,7 +2357,14 @@ auto registry<Policies...>::finalize(Options... opts) -> void {
         }
     });
 
+    if constexpr (has_replication) {
+        detail::replication_state<registry>::release();
+    }
+
     dispatch_data.clear();
+    detail::compact_vptrs<registry>.clear();
+    detail::compact_type_indexes<registry>.clear();
+
     initialized = false;
 }
 
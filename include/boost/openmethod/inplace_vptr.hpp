@@ -3,6 +3,10 @@
 
 #include <boost/openmethod/core.hpp>
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 // =============================================================================
 // inplace_vptr
 
@@ -37,7 +41,12 @@ void boost_openmethod_update_vptr(Class* obj) {
     using bases = decltype(boost_openmethod_bases(obj));
 
     if constexpr (mp11::mp_size<bases>::value == 0) {
-        if constexpr (registry::has_indirect_vptr) {
+        if constexpr (std::is_base_of_v<
+                          compact_inplace_vptr_base<Class, registry>, Class>) {
+            obj->boost_openmethod_vptr =
+                compact_inplace_vptr_base<Class, registry>::template encode<
+                    To>();
+        } else if constexpr (registry::has_indirect_vptr) {
             obj->boost_openmethod_vptr = &registry::template static_vptr<To>;
         } else {
             obj->boost_openmethod_vptr = registry::template static_vptr<To>;
@@ -156,6 +165,107 @@ class inplace_vptr_base : protected detail::inplace_vptr_base_tag {
     }
 };
 
+//! Embed a compact v-table pointer in a class.
+//!
+//! `compact_inplace_vptr_base` is a variant of @ref inplace_vptr_base that
+//! stores a 32-bit integer in objects, instead of a pointer. It is used in the
+//! same way, with @ref inplace_vptr_derived in derived classes. On 64-bit
+//! platforms, this saves four bytes per object, or eight if the other members
+//! fit in the four bytes that would otherwise be padding.
+//!
+//! If `Registry` does not contain the @ref has_indirect_vptr policy, the
+//! integer is the signed offset of the class' v-table pointer from the start
+//! of the dispatch data, in words. @ref boost_openmethod_vptr adds it to the
+//! address of the dispatch data. If the registry contains the @ref
+//! runtime_checks policy, and the offset does not fit in 32 bits, calls the
+//! registry's @ref error_handler, if it has one, with a @ref
+//! compact_vptr_overflow value, then terminates the program with @ref abort.
+//! Like with @ref inplace_vptr_base, the objects must be created after the
+//! last call to @ref initialize. This mode cannot be used with a @ref
+//! vtbl_storage policy.
+//!
+//! If `Registry` contains the @ref has_indirect_vptr policy, the integer is
+//! an index, assigned to the class when it is registered, in a table of
+//! v-table pointers rebuilt by @ref initialize. `boost_openmethod_vptr` reads
+//! the table at that index. The index remains valid after a call to
+//! `initialize`, for example after loading a shared library.
+//!
+//! @tparam Class The class in which to embed the v-table pointer.
+//! @tparam Registry The @ref registry in which `Class` and its derived classes
+//! are registered.
+template<class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY>
+class compact_inplace_vptr_base : protected detail::inplace_vptr_base_tag {
+    template<class To, class Other>
+    friend void detail::boost_openmethod_update_vptr(Other*);
+    friend auto boost_openmethod_registry(Class*) -> Registry;
+    friend auto boost_openmethod_bases(Class*) -> mp11::mp_list<>;
+
+    // An index in indirect mode; otherwise, an offset that may be negative,
+    // because v-table pointers are biased by the class' first slot.
+    using encoded_vptr = std::conditional_t<
+        Registry::has_indirect_vptr, std::uint32_t, std::int32_t>;
+
+    encoded_vptr boost_openmethod_vptr = 0;
+
+    static auto dispatch_data() noexcept -> vptr_type {
+        return Registry::dispatch_data.data();
+    }
+
+    template<class To>
+    static auto encode() noexcept -> encoded_vptr {
+        if constexpr (Registry::has_indirect_vptr) {
+            (void)&detail::use_compact_vptrs<typename Registry::registry_type>;
+
+            return detail::compact_vptr_index<
+                typename Registry::registry_type, To>;
+        } else {
+            static_assert(
+                !Registry::has_vtbl_storage,
+                "the v-tables must be in the dispatch data");
+
+            auto offset = Registry::template static_vptr<To> - dispatch_data();
+
+            if constexpr (Registry::has_runtime_checks) {
+                if (offset < (std::numeric_limits<encoded_vptr>::min)() ||
+                    offset > (std::numeric_limits<encoded_vptr>::max)()) {
+                    if constexpr (Registry::has_error_handler) {
+                        compact_vptr_overflow error;
+                        error.type =
+                            Registry::rtti::template static_type<To>();
+                        Registry::error_handler::error(error);
+                    }
+
+                    abort();
+                }
+            }
+
+            return encoded_vptr(offset);
+        }
+    }
+
+    friend auto
+    boost_openmethod_vptr(const Class& obj, Registry*) noexcept -> vptr_type {
+        if constexpr (Registry::has_indirect_vptr) {
+            return *detail::compact_vptrs<
+                typename Registry::registry_type>[obj.boost_openmethod_vptr];
+        } else {
+            return dispatch_data() + obj.boost_openmethod_vptr;
+        }
+    }
+
+  protected:
+    //! Set the vptr to `Class`\'s v-table.
+    compact_inplace_vptr_base() noexcept {
+        (void)&detail::inplace_vptr_use_classes<Class, Registry>;
+        detail::boost_openmethod_update_vptr<Class>(static_cast<Class*>(this));
+    }
+
+    //! Set the vptr to 0.
+    ~compact_inplace_vptr_base() noexcept {
+        boost_openmethod_vptr = 0;
+    }
+};
+
 #ifdef __MRDOCS__
 //! Adjust the v-table pointer embedded in a class.
 //!
@@ -274,6 +384,7 @@ class inplace_vptr_derived<Class, Base1, Base2, MoreBases...> {
 };
 
 namespace aliases {
+using boost::openmethod::compact_inplace_vptr_base;
 using boost::openmethod::inplace_vptr_base;
 using boost::openmethod::inplace_vptr_derived;
 } // namespace aliases
@@ -50,8 +50,7 @@ struct virtual_traits<boost::intrusive_ptr<Class>, Registry> {
         if constexpr (detail::requires_dynamic_cast<Class*, element_type*>) {
             // make it work with custom RTTI
             return OverriderType(
-                &Registry::rtti::template dynamic_cast_ref<element_type&>(
-                    *obj));
+                &detail::dynamic_cast_ref<Registry, element_type&>(*obj));
         } else {
             return boost::static_pointer_cast<element_type>(obj);
         }
@@ -104,8 +103,7 @@ struct virtual_traits<const boost::intrusive_ptr<Class>&, Registry> {
                 // make it work with custom RTTI
                 return std::remove_const_t<
                     std::remove_reference_t<OverriderType>>(
-                    &Registry::rtti::template dynamic_cast_ref<element_type&>(
-                        *obj));
+                    &detail::dynamic_cast_ref<Registry, element_type&>(*obj));
             } else {
                 return boost::static_pointer_cast<element_type>(obj);
             }
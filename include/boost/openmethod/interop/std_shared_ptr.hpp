@@ -8,6 +8,11 @@
 
 #include <boost/openmethod/core.hpp>
 #include <memory>
+#include <type_traits>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 
 namespace boost::openmethod {
 namespace detail {
@@ -32,6 +37,15 @@ struct shared_ptr_cast_traits<std::shared_ptr<T>&&> {
     using virtual_type = T;
 };
 
+// Cast using the registry's downcast policy. The result shares ownership with
+// `obj`.
+template<class Registry, class T, class SharedPtr>
+auto downcast_shared_ptr(SharedPtr&& obj) -> std::shared_ptr<T> {
+    auto ptr = &dynamic_cast_ref<Registry, T&>(*obj);
+
+    return std::shared_ptr<T>(std::forward<SharedPtr>(obj), ptr);
+}
+
 template<typename T, class Registry>
 struct validate_method_parameter<std::shared_ptr<T>&, Registry, void>
     : std::false_type {
@@ -77,6 +91,8 @@ struct virtual_traits<std::shared_ptr<Class>, Registry> {
     //!
     //! Cast to a `std::shared_ptr` to another type. If possible, use
     //! `std::static_pointer_cast`. Otherwise, use `std::dynamic_pointer_cast`.
+    //! If the registry has a @ref downcast policy, use it instead of
+    //! `std::dynamic_pointer_cast`.
     //!
     //! @tparam Derived A lvalue reference type to a `std::shared_ptr`.
     //! @param obj A reference to a `const shared_ptr<Class>`.
@@ -88,8 +104,16 @@ struct virtual_traits<std::shared_ptr<Class>, Registry> {
 
         if constexpr (requires_dynamic_cast<
                           Class*, typename Derived::element_type*>) {
-            return std::dynamic_pointer_cast<
-                typename shared_ptr_cast_traits<Derived>::virtual_type>(obj);
+            if constexpr (Registry::has_downcast) {
+                return downcast_shared_ptr<
+                    Registry,
+                    typename shared_ptr_cast_traits<Derived>::virtual_type>(
+                    obj);
+            } else {
+                return std::dynamic_pointer_cast<
+                    typename shared_ptr_cast_traits<Derived>::virtual_type>(
+                    obj);
+            }
         } else {
             return std::static_pointer_cast<
                 typename shared_ptr_cast_traits<Derived>::virtual_type>(obj);
@@ -102,6 +126,8 @@ struct virtual_traits<std::shared_ptr<Class>, Registry> {
     //! Cast to a `std::shared_ptr` xvalue reference to another type. If
     //! possible, use `std::static_pointer_cast`. Otherwise, use
     //! `std::dynamic_pointer_cast`.
+    //! If the registry has a @ref downcast policy, use it instead of
+    //! `std::dynamic_pointer_cast`.
     //!
     //! @note This overload is only available for C++20 and above, because
     //! rvalue references overloads of `std::static_pointer_cast` and
@@ -117,9 +143,16 @@ struct virtual_traits<std::shared_ptr<Class>, Registry> {
 
         if constexpr (requires_dynamic_cast<
                           Class*, decltype(std::declval<Derived>().get())>) {
-            return std::dynamic_pointer_cast<
-                typename shared_ptr_cast_traits<Derived>::virtual_type>(
-                std::move(obj));
+            if constexpr (Registry::has_downcast) {
+                return downcast_shared_ptr<
+                    Registry,
+                    typename shared_ptr_cast_traits<Derived>::virtual_type>(
+                    std::move(obj));
+            } else {
+                return std::dynamic_pointer_cast<
+                    typename shared_ptr_cast_traits<Derived>::virtual_type>(
+                    std::move(obj));
+            }
         } else {
             return std::static_pointer_cast<
                 typename shared_ptr_cast_traits<Derived>::virtual_type>(
@@ -161,6 +194,8 @@ struct virtual_traits<const std::shared_ptr<Class>&, Registry> {
     //!
     //! Cast to a `std::shared_ptr` to another type. If possible, use
     //! `std::static_pointer_cast`. Otherwise, use `std::dynamic_pointer_cast`.
+    //! If the registry has a @ref downcast policy, use it instead of
+    //! `std::dynamic_pointer_cast`.
     //!
     //! @tparam Derived A lvalue reference type to a `std::shared_ptr`.
     //! @param obj A reference to a `const shared_ptr<Class>`.
@@ -175,8 +210,16 @@ struct virtual_traits<const std::shared_ptr<Class>&, Registry> {
             using namespace boost::openmethod::detail;
 
             if constexpr (requires_dynamic_cast<Class*, Other>) {
-                return std::dynamic_pointer_cast<
-                    typename shared_ptr_cast_traits<Other>::virtual_type>(obj);
+                if constexpr (Registry::has_downcast) {
+                    return downcast_shared_ptr<
+                        Registry,
+                        typename shared_ptr_cast_traits<Other>::virtual_type>(
+                        obj);
+                } else {
+                    return std::dynamic_pointer_cast<
+                        typename shared_ptr_cast_traits<Other>::virtual_type>(
+                        obj);
+                }
             } else {
                 return std::static_pointer_cast<
                     typename shared_ptr_cast_traits<Other>::virtual_type>(obj);
@@ -211,7 +254,63 @@ inline auto make_shared_virtual(T&&... args) {
         std::make_shared<Class>(std::forward<T>(args)...));
 }
 
+//! Create a new object with an allocator and return a `shared_virtual_ptr` to
+//! it.
+//!
+//! Create an object using `std::allocate_shared`, and return a @ref
+//! shared_virtual_ptr pointing to it. Since the exact class of the object is
+//! known, the `virtual_ptr` is created using @ref final_virtual_ptr.
+//!
+//! `Class` is _not_ required to be a polymorphic class.
+//!
+//! @tparam Class The class of the object to create.
+//! @tparam Registry A @ref registry.
+//! @tparam Allocator An allocator type.
+//! @tparam T Types of the arguments to pass to the constructor of `Class`.
+//! @param alloc The allocator used for the object and its control block.
+//! @param args Arguments to pass to the constructor of `Class`.
+//! @return A `shared_virtual_ptr<Class, Registry>` pointing to a newly
+//! created object of type `Class`.
+template<
+    class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY,
+    class Allocator, typename... T
+#ifndef __MRDOCS__
+    ,
+    typename = std::enable_if_t<!std::is_pointer_v<Allocator>>
+#endif
+    >
+inline auto allocate_shared_virtual(const Allocator& alloc, T&&... args) {
+    return final_virtual_ptr<Registry>(
+        std::allocate_shared<Class>(alloc, std::forward<T>(args)...));
+}
+
+#if defined(__cpp_lib_memory_resource) || defined(__MRDOCS__)
+//! Create a new object in a memory resource and return a `shared_virtual_ptr`
+//! to it.
+//!
+//! Same as `allocate_shared_virtual<Class, Registry>(alloc, args...)`, with a
+//! `std::pmr::polymorphic_allocator` that uses `resource`.
+//!
+//! @tparam Class The class of the object to create.
+//! @tparam Registry A @ref registry.
+//! @tparam T Types of the arguments to pass to the constructor of `Class`.
+//! @param resource A memory resource.
+//! @param args Arguments to pass to the constructor of `Class`.
+//! @return A `shared_virtual_ptr<Class, Registry>` pointing to a newly
+//! created object of type `Class`.
+template<
+    class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY,
+    typename... T>
+inline auto
+allocate_shared_virtual(std::pmr::memory_resource* resource, T&&... args) {
+    return allocate_shared_virtual<Class, Registry>(
+        std::pmr::polymorphic_allocator<Class>(resource),
+        std::forward<T>(args)...);
+}
+#endif
+
 namespace aliases {
+using boost::openmethod::allocate_shared_virtual;
 using boost::openmethod::make_shared_virtual;
 using boost::openmethod::shared_virtual_ptr;
 } // namespace aliases
@@ -8,49 +8,84 @@
 
 #include <boost/openmethod/core.hpp>
 
+#include <cstddef>
 #include <memory>
+#include <type_traits>
+
+#include <boost/assert.hpp>
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
 
 namespace boost::openmethod {
 
+namespace detail {
+
+// The deleter of a `unique_ptr` rebound to another element type.
+// `std::default_delete` is specific to its class; other deleters are assumed
+// not to be.
+template<class Deleter, class Other>
+struct rebind_deleter {
+    using type = Deleter;
+};
+
+template<class Class, class Other>
+struct rebind_deleter<std::default_delete<Class>, Other> {
+    using type = std::default_delete<Other>;
+};
+
+} // namespace detail
+
 //! Specialize virtual_traits for std::unique_ptr by value.
 //!
 //! @tparam Class A class type, possibly cv-qualified.
+//! @tparam Deleter The deleter type.
 //! @tparam Registry A @ref registry.
-template<class Class, class Registry>
-struct virtual_traits<std::unique_ptr<Class>, Registry> {
+template<class Class, class Deleter, class Registry>
+struct virtual_traits<std::unique_ptr<Class, Deleter>, Registry> {
     //! `Class`, stripped from cv-qualifiers.
     using virtual_type = std::remove_cv_t<Class>;
 
     //! Return a reference to a non-modifiable `Class` object.
-    //! @param arg A reference to a `std::unique_ptr<Class>`.
+    //! @param arg A reference to a `std::unique_ptr<Class, Deleter>`.
     //! @return A reference to the object pointed to.
-    static auto peek(const std::unique_ptr<Class>& arg) -> const Class& {
+    static auto peek(const std::unique_ptr<Class, Deleter>& arg)
+        -> const Class& {
         return *arg;
     }
 
     //! Cast to a type.
     //!
     //! Cast a reference to the managed object, using `static_cast` if possible,
-    //! and `Registry::rtti::dynamic_cast_ref` otherwise. If the cast succeeds,
-    //! transfer ownership to a `std::unique_ptr` to the target type, and return
-    //! it.
+    //! and the registry's @ref downcast policy, or
+    //! `Registry::rtti::dynamic_cast_ref`, otherwise. If the cast succeeds,
+    //! transfer ownership, and the deleter, to a `std::unique_ptr` to the
+    //! target type, and return it.
     //!
     //! @tparam Derived A xvalue reference to a `std::unique_ptr`.
     //! @param obj A xvalue reference to a `std::unique_ptr`.
     //! @return A `std::unique_ptr<Derived::element_type>`.
     template<typename Derived>
-    static auto cast(std::unique_ptr<Class>&& ptr) {
+    static auto cast(std::unique_ptr<Class, Deleter>&& ptr) {
+        typename Derived::element_type* p;
+
         if constexpr (detail::requires_dynamic_cast<Class&, Derived&>) {
-            auto p = &Registry::rtti::template dynamic_cast_ref<
-                typename Derived::element_type&>(*ptr);
+            p = &detail::dynamic_cast_ref<
+                Registry, typename Derived::element_type&>(*ptr);
+        } else {
+            p = &static_cast<typename Derived::element_type&>(*ptr);
+        }
+
+        if constexpr (std::is_same_v<Deleter, std::default_delete<Class>>) {
             // coverity[alloc_fn]
             ptr.release();
             return Derived(p);
         } else {
-            auto p = &static_cast<typename Derived::element_type&>(*ptr);
+            Derived result(p, std::move(ptr.get_deleter()));
             // coverity[alloc_fn]
             ptr.release();
-            return Derived(p);
+            return result;
         }
     }
 
@@ -58,7 +93,8 @@ struct virtual_traits<std::unique_ptr<Class>, Registry> {
     //!
     //! @tparam Other The new element type.
     template<class Other>
-    using rebind = std::unique_ptr<Other>;
+    using rebind = std::unique_ptr<
+        Other, typename detail::rebind_deleter<Deleter, Other>::type>;
 };
 
 //! Alias for a `virtual_ptr<std::unique_ptr<T>>`.
@@ -87,7 +123,147 @@ inline auto make_unique_virtual(T&&... args) {
         std::make_unique<Class>(std::forward<T>(args)...));
 }
 
+//! Deleter for objects created by `allocate_unique_virtual`.
+//!
+//! `allocator_delete` destroys the object it was created for, and returns its
+//! memory to a copy of the allocator that provided it. It remembers the
+//! address and the class of the complete object, so a `std::unique_ptr` that
+//! uses it can be converted to a `std::unique_ptr` to a base class.
+//!
+//! @note The deleter ignores the pointer it is called with, and always
+//! destroys the object it was created for. Thus, `reset(p)` with another
+//! pointer, or `release` followed by adopting the pointer in a
+//! `std::unique_ptr` with a different deleter, are not supported. If the
+//! element type is polymorphic, and RTTI is enabled, this is checked with
+//! `BOOST_ASSERT`.
+//!
+//! @tparam Allocator An allocator of `std::byte`.
+template<class Allocator>
+class allocator_delete {
+    Allocator alloc;
+    void* object = nullptr;
+    void (*destroy)(Allocator&, void*) = nullptr;
+
+  public:
+    //! Construct an empty deleter.
+    allocator_delete() = default;
+
+    //! Construct a deleter for an object.
+    //!
+    //! @tparam Class The class of the object.
+    //! @param alloc The allocator that provided the object's memory.
+    //! @param obj A pointer to the object.
+    template<class Class>
+    allocator_delete(const Allocator& alloc, Class* obj)
+        : alloc(alloc), object(obj), destroy([](Allocator& alloc, void* obj) {
+              using traits = typename std::allocator_traits<
+                  Allocator>::template rebind_traits<Class>;
+              typename traits::allocator_type class_alloc(alloc);
+              auto p = static_cast<Class*>(obj);
+              traits::destroy(class_alloc, p);
+              traits::deallocate(class_alloc, p, 1);
+          }) {
+    }
+
+    //! Destroy the object and deallocate its memory.
+    //!
+    //! @tparam T The element type of the `std::unique_ptr`.
+    //! @param p A pointer to the object, possibly to a base class subobject.
+    template<class T>
+    auto operator()(T* p) -> void {
+#ifndef BOOST_NO_RTTI
+        if constexpr (std::is_polymorphic_v<T>) {
+            BOOST_ASSERT(dynamic_cast<const volatile void*>(p) == object);
+        }
+#endif
+        (void)p;
+        destroy(alloc, object);
+    }
+};
+
+//! Create a new object with an allocator and return a `virtual_ptr` to it.
+//!
+//! Allocate memory for an object using a copy of `alloc` rebound to `Class`,
+//! construct the object with `args`, and return a `virtual_ptr` to a
+//! `std::unique_ptr` that uses an @ref allocator_delete. Since the exact class
+//! of the object is known, the `virtual_ptr` is created using @ref
+//! final_virtual_ptr.
+//!
+//! `Class` is _not_ required to be a polymorphic class.
+//!
+//! @tparam Class The class of the object to create.
+//! @tparam Registry A @ref registry.
+//! @tparam Allocator An allocator type.
+//! @tparam T Types of the arguments to pass to the constructor of `Class`.
+//! @param alloc The allocator.
+//! @param args Arguments to pass to the constructor of `Class`.
+//! @return A `virtual_ptr<std::unique_ptr<Class, allocator_delete<...>>,
+//! Registry>` pointing to a newly created object of type `Class`.
+template<
+    class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY,
+    class Allocator, typename... T
+#ifndef __MRDOCS__
+    ,
+    typename = std::enable_if_t<!std::is_pointer_v<Allocator>>
+#endif
+    >
+inline auto allocate_unique_virtual(const Allocator& alloc, T&&... args) {
+    using byte_allocator = typename std::allocator_traits<
+        Allocator>::template rebind_alloc<std::byte>;
+    using traits = typename std::allocator_traits<
+        Allocator>::template rebind_traits<Class>;
+
+    // Return the memory if the constructor throws.
+    struct guard {
+        typename traits::allocator_type alloc;
+        Class* p;
+
+        ~guard() {
+            if (p) {
+                traits::deallocate(alloc, p, 1);
+            }
+        }
+    };
+
+    guard memory{typename traits::allocator_type(alloc), nullptr};
+    memory.p = traits::allocate(memory.alloc, 1);
+    traits::construct(memory.alloc, memory.p, std::forward<T>(args)...);
+
+    std::unique_ptr<Class, allocator_delete<byte_allocator>> ptr(
+        memory.p, allocator_delete<byte_allocator>(
+                      byte_allocator(alloc), memory.p));
+    memory.p = nullptr;
+
+    return final_virtual_ptr<Registry>(std::move(ptr));
+}
+
+#if defined(__cpp_lib_memory_resource) || defined(__MRDOCS__)
+//! Create a new object in a memory resource and return a `virtual_ptr` to it.
+//!
+//! Same as `allocate_unique_virtual<Class, Registry>(alloc, args...)`, with a
+//! `std::pmr::polymorphic_allocator` that uses `resource`.
+//!
+//! @tparam Class The class of the object to create.
+//! @tparam Registry A @ref registry.
+//! @tparam T Types of the arguments to pass to the constructor of `Class`.
+//! @param resource A memory resource.
+//! @param args Arguments to pass to the constructor of `Class`.
+//! @return A `virtual_ptr` to a `std::unique_ptr` to a newly created object
+//! of type `Class`.
+template<
+    class Class, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY,
+    typename... T>
+inline auto
+allocate_unique_virtual(std::pmr::memory_resource* resource, T&&... args) {
+    return allocate_unique_virtual<Class, Registry>(
+        std::pmr::polymorphic_allocator<std::byte>(resource),
+        std::forward<T>(args)...);
+}
+#endif
+
 namespace aliases {
+using boost::openmethod::allocate_unique_virtual;
+using boost::openmethod::allocator_delete;
 using boost::openmethod::make_unique_virtual;
 using boost::openmethod::unique_virtual_ptr;
 } // namespace aliases
@@ -0,0 +1,176 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_INTEROP_STD_VARIANT_HPP
+#define BOOST_OPENMETHOD_INTEROP_STD_VARIANT_HPP
+
+#include <boost/openmethod/core.hpp>
+
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace boost::openmethod {
+
+namespace detail {
+
+template<class Variant, typename Derived, class Arg>
+auto variant_cast(Arg& obj) -> Derived {
+    using Alternative = std::remove_cv_t<std::remove_reference_t<Derived>>;
+
+    if constexpr (std::is_same_v<Alternative, Variant>) {
+        return obj;
+    } else {
+        // The overrider was selected for this alternative: the variant
+        // necessarily holds it.
+        return *std::get_if<Alternative>(&obj);
+    }
+}
+
+} // namespace detail
+
+//! Return the v-table pointer for the alternative held by a `std::variant`.
+//!
+//! Makes `std::variant` usable in `virtual_` parameters. The v-table pointer
+//! is read from a table, indexed by `variant::index()`, of pointers to the
+//! @ref registry::static_vptr of the alternatives. No RTTI and no hashing are
+//! involved.
+//!
+//! If `Registry` contains the @ref runtime_checks policy, and the variant is
+//! valueless, calls the registry's @ref error_handler, if it has one, with a
+//! @ref missing_class value, then terminates the program with @ref abort.
+//!
+//! @tparam Ts The types of the alternatives.
+//! @tparam Registry A @ref registry.
+//! @param arg A reference to a variant.
+//! @return The v-table pointer for the alternative held by `arg`.
+template<class... Ts, class Registry>
+auto boost_openmethod_vptr(const std::variant<Ts...>& arg, Registry*)
+    -> vptr_type {
+    static const vptr_type* const vptrs[] = {
+        &Registry::template static_vptr<Ts>...};
+
+    if constexpr (Registry::has_runtime_checks) {
+        if (arg.valueless_by_exception()) {
+            if constexpr (Registry::has_error_handler) {
+                missing_class error;
+                error.type = Registry::rtti::template static_type<
+                    std::variant<Ts...>>();
+                Registry::error_handler::error(error);
+            }
+
+            abort();
+        }
+    }
+
+    return *vptrs[arg.index()];
+}
+
+//! Specialize virtual_traits for `std::variant` lvalue references.
+//!
+//! The virtual type is the variant itself. Overriders take references to the
+//! alternatives, or to the variant.
+//!
+//! @tparam Ts The types of the alternatives.
+//! @tparam Registry A @ref registry.
+template<class... Ts, class Registry>
+struct virtual_traits<std::variant<Ts...>&, Registry> {
+    //! The variant type.
+    using virtual_type = std::variant<Ts...>;
+
+    //! Return a reference to a non-modifiable variant.
+    //! @param arg A reference to a variant.
+    //! @return A reference to the same variant.
+    static auto peek(const std::variant<Ts...>& arg)
+        -> const std::variant<Ts...>& {
+        return arg;
+    }
+
+    //! Cast to an alternative.
+    //!
+    //! Returns a reference to the alternative held by the variant, using
+    //! `std::get_if` without checking the result.
+    //!
+    //! @tparam Derived A lvalue reference to an alternative, or to the variant.
+    //! @param obj A reference to a variant.
+    //! @return A reference to the alternative.
+    template<typename Derived>
+    static auto cast(std::variant<Ts...>& obj) -> Derived {
+        static_assert(std::is_lvalue_reference_v<Derived>);
+        return detail::variant_cast<std::variant<Ts...>, Derived>(obj);
+    }
+};
+
+//! Specialize virtual_traits for `std::variant` const lvalue references.
+//!
+//! @tparam Ts The types of the alternatives.
+//! @tparam Registry A @ref registry.
+template<class... Ts, class Registry>
+struct virtual_traits<const std::variant<Ts...>&, Registry> {
+    //! The variant type.
+    using virtual_type = std::variant<Ts...>;
+
+    //! Return a reference to a non-modifiable variant.
+    //! @param arg A reference to a variant.
+    //! @return A reference to the same variant.
+    static auto peek(const std::variant<Ts...>& arg)
+        -> const std::variant<Ts...>& {
+        return arg;
+    }
+
+    //! Cast to an alternative.
+    //!
+    //! Returns a reference to the alternative held by the variant, using
+    //! `std::get_if` without checking the result.
+    //!
+    //! @tparam Derived A const lvalue reference to an alternative, or to the
+    //! variant.
+    //! @param obj A reference to a variant.
+    //! @return A reference to the alternative.
+    template<typename Derived>
+    static auto cast(const std::variant<Ts...>& obj) -> Derived {
+        static_assert(std::is_lvalue_reference_v<Derived>);
+        return detail::variant_cast<std::variant<Ts...>, Derived>(obj);
+    }
+};
+
+//! Add a `std::variant` and its alternatives to a registry.
+//!
+//! `use_variant` is a registrar class, like @ref use_classes. It registers
+//! the variant as a class, and each alternative as a class derived from it.
+//! The alternatives need not be polymorphic, or even classes. They may also
+//! be registered in other hierarchies.
+//!
+//! @par Example
+//!
+//! @code
+//! using Shape = std::variant<Circle, Square>;
+//! BOOST_OPENMETHOD_REGISTER(use_variant<Shape>);
+//!
+//! BOOST_OPENMETHOD(area, (virtual_<const Shape&>), double);
+//!
+//! BOOST_OPENMETHOD_OVERRIDE(area, (const Circle& c), double) {
+//!     return 3.14159 * c.r * c.r;
+//! }
+//! @endcode
+//!
+//! @tparam Variant A `std::variant` type.
+//! @tparam Registry A @ref registry.
+template<class Variant, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY>
+class use_variant;
+
+template<class... Ts, class Registry>
+class use_variant<std::variant<Ts...>, Registry> {
+    using Variant = std::variant<Ts...>;
+
+    detail::use_class_aux<Registry, mp11::mp_list<Variant, Variant>> variant;
+    std::tuple<
+        detail::use_class_aux<Registry, mp11::mp_list<Ts, Ts, Variant>>...>
+        alternatives;
+};
+
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,35 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_DECISION_TREE_HPP
+#define BOOST_OPENMETHOD_POLICY_DECISION_TREE_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+namespace boost::openmethod::policies {
+
+//! Dispatches large multi-methods via decision trees.
+//!
+//! `decision_tree` replaces the dispatch table of a multi-method with a
+//! decision tree if the table has more than `Threshold` cells, and if the tree
+//! is smaller than the table.
+//!
+//! @tparam Threshold The number of cells above which a dispatch table is
+//! compressed.
+template<std::size_t Threshold = 4096>
+struct decision_tree : sparse_dispatch {
+    //! A SparseDispatchFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    struct fn {
+        //! Number of cells above which a dispatch table is compressed.
+        static constexpr std::size_t threshold = Threshold;
+    };
+};
+
+} // namespace boost::openmethod::policies
+
+#endif
@@ -71,7 +71,8 @@ struct default_error_handler : error_handler {
             void,
             std::variant<
                 not_initialized, no_overrider, ambiguous_call, missing_class,
-                missing_base, odr_violation, final_error>,
+                missing_base, odr_violation, final_error,
+                compact_vptr_overflow, compact_address_overflow>,
             typename Registry::policy_list>::type;
 
         //! The type of the error handler function object.
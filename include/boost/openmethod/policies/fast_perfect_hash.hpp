@@ -8,8 +8,12 @@
 
 #include <boost/openmethod/preamble.hpp>
 
+#include <boost/mp11/tuple.hpp>
+
 #include <limits>
 #include <random>
+#include <variant>
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4702) // unreachable code
@@ -33,8 +37,40 @@ constexpr uintptr uintptr_max = (std::numeric_limits<std::size_t>::max)();
 template<class Registry>
 std::vector<type_id> fast_perfect_hash_control;
 
+// The finalizer of the SplitMix64 generator. It is a bijection, so distinct
+// counters produce distinct values.
+inline auto splitmix64(std::uint64_t x) -> std::uint64_t {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+
+    return x ^ (x >> 31);
+}
+
 } // namespace detail
 
+// Defined in <boost/openmethod/policies/parallel_hash_search.hpp>.
+struct parallel_hash_search;
+
+//! Try a known multiplier before searching for hash factors.
+//!
+//! If `hash_multiplier` is present in @ref initialize's `Options`, @ref
+//! policies::fast_perfect_hash first tries `value` with a table of `2^bits`
+//! buckets. If it yields no collisions, the search is skipped entirely.
+//! Otherwise, or if `bits` is not one of the table sizes a search would
+//! consider, the fallback is shown in the trace, and the search proceeds as
+//! usual. Thus, a stale multiplier never yields a larger table than a search.
+//!
+//! The factors found by a previous run are returned by
+//! `fast_perfect_hash::fn<Registry>::factors()`, and shown in the trace.
+struct hash_multiplier {
+    //! The multiplier to try.
+    std::size_t value = 0;
+    //! The base 2 logarithm of the number of buckets the multiplier was found
+    //! for; 0 means the smallest table a search would consider.
+    std::size_t bits = 0;
+};
+
 namespace policies {
 
 //! Hash type ids using a fast, perfect hash function.
@@ -49,6 +85,11 @@ namespace policies {
 //! corresponds to a value in the domain, or even that the codomain is a dense
 //! range of integers. In other words, a lot of space may be wasted in presence
 //! of large sets of type_ids.
+//!
+//! The search can be spread across several threads with the @ref
+//! parallel_hash_search option, defined in
+//! `<boost/openmethod/policies/parallel_hash_search.hpp>`, and skipped with the
+//! @ref hash_multiplier option.
 struct fast_perfect_hash : type_hash {
 
     //! Cannot find hash factors
@@ -80,6 +121,23 @@ struct fast_perfect_hash : type_hash {
 
         static void check(std::size_t index, type_id type);
 
+        template<class InitializeContext>
+        static auto try_factors(
+            const InitializeContext& ctx, std::vector<type_id>& buckets,
+            std::size_t candidate, std::size_t candidate_shift,
+            std::size_t& low, std::size_t& high) -> bool;
+
+        // Defined in <boost/openmethod/policies/parallel_hash_search.hpp>.
+        template<class... Options>
+        static auto search_threads(const std::tuple<Options...>& options)
+            -> std::size_t;
+
+        template<class InitializeContext>
+        static auto search_parallel(
+            const InitializeContext& ctx, std::vector<type_id>& buckets,
+            std::size_t threads, std::size_t pass, std::size_t& attempts)
+            -> bool;
+
         template<class InitializeContext, class... Options>
         static void initialize(
             const InitializeContext& ctx, std::vector<type_id>& buckets,
@@ -127,8 +185,7 @@ struct fast_perfect_hash : type_hash {
         //! @return The hash value
         BOOST_FORCEINLINE
         static auto hash(type_id type) -> std::size_t {
-            auto index =
-                (mult * reinterpret_cast<detail::uintptr>(type)) >> shift;
+            auto index = unchecked_hash(type);
 
             if constexpr (Registry::has_runtime_checks) {
                 check(index, type);
@@ -137,6 +194,47 @@ struct fast_perfect_hash : type_hash {
             return index;
         }
 
+        //! Hash a type id, without checking it
+        //!
+        //! Hash a type id, even if `Registry` contains the @ref
+        //! runtime_checks policy. The result may exceed the maximum value
+        //! returned by @ref initialize. Used by @ref vptr_vector, which
+        //! performs the check itself.
+        //!
+        //! @param type The type_id to hash
+        //! @return The hash value
+        BOOST_FORCEINLINE
+        static auto unchecked_hash(type_id type) -> std::size_t {
+            return (mult * reinterpret_cast<detail::uintptr>(type)) >> shift;
+        }
+
+        //! Returns the multiplication factor
+        //!
+        //! Returns the multiplication factor `M` found by the last call to
+        //! `initialize`. It can be passed to a later call, via the @ref
+        //! hash_multiplier option, to skip the search.
+        //!
+        //! @return The multiplication factor.
+        static auto multiplier() -> std::size_t {
+            return mult;
+        }
+
+        //! Returns the hash factors
+        //!
+        //! Returns the multiplication factor `M` found by the last call to
+        //! `initialize`, and the size of the table it was found for, as a @ref
+        //! hash_multiplier option that can be passed to a later call, to skip
+        //! the search.
+        //!
+        //! @return A @ref hash_multiplier option.
+        static auto factors() -> hash_multiplier {
+            hash_multiplier result;
+            result.value = mult;
+            result.bits = 8 * sizeof(type_id) - shift;
+
+            return result;
+        }
+
         //! Releases the memory allocated by `initialize`.
         //!
         //! @tparam Options... Zero or more option types, deduced from the function
@@ -161,6 +259,35 @@ std::size_t fast_perfect_hash::fn<Registry>::min_value;
 template<class Registry>
 std::size_t fast_perfect_hash::fn<Registry>::max_value;
 
+template<class Registry>
+template<class InitializeContext>
+auto fast_perfect_hash::fn<Registry>::try_factors(
+    const InitializeContext& ctx, std::vector<type_id>& buckets,
+    std::size_t candidate, std::size_t candidate_shift, std::size_t& low,
+    std::size_t& high) -> bool {
+    std::fill(buckets.begin(), buckets.end(), type_id(detail::uintptr_max));
+    low = (std::numeric_limits<std::size_t>::max)();
+    high = (std::numeric_limits<std::size_t>::min)();
+
+    for (auto iter = ctx.classes_begin(); iter != ctx.classes_end(); ++iter) {
+        for (auto type_iter = iter->type_id_begin();
+             type_iter != iter->type_id_end(); ++type_iter) {
+            auto type = *type_iter;
+            auto index = (detail::uintptr(type) * candidate) >> candidate_shift;
+            low = (std::min)(low, index);
+            high = (std::max)(high, index);
+
+            if (detail::uintptr(buckets[index]) != detail::uintptr_max) {
+                return false;
+            }
+
+            buckets[index] = type;
+        }
+    }
+
+    return true;
+}
+
 template<class Registry>
 template<class InitializeContext, class... Options>
 void fast_perfect_hash::fn<Registry>::initialize(
@@ -182,56 +309,101 @@ void fast_perfect_hash::fn<Registry>::initialize(
         ++M;
     }
 
+    if constexpr (mp11::mp_contains<
+                      mp11::mp_list<Options...>, hash_multiplier>::value) {
+        hash_multiplier known;
+
+        mp11::tuple_for_each(options, [&known](const auto& option) {
+            if constexpr (std::is_same_v<
+                              std::decay_t<decltype(option)>,
+                              hash_multiplier>) {
+                known = option;
+            }
+        });
+
+        auto bits = known.bits ? known.bits : M;
+
+        // Accept only the table sizes that a search would consider.
+        if (bits >= M && bits < M + 4) {
+            shift = 8 * sizeof(type_id) - bits;
+            buckets.resize(std::size_t(1) << bits);
+            ++total_attempts;
+
+            if (try_factors(
+                    ctx, buckets, known.value, shift, min_value, max_value)) {
+                mult = known.value;
+
+                if constexpr (InitializeContext::template has_option<trace>) {
+                    ctx.tr << "  reusing " << mult << " with M = " << bits
+                           << "; span = [" << min_value << ", " << max_value
+                           << "]\n";
+                }
+
+                return;
+            }
+        }
+
+        if constexpr (InitializeContext::template has_option<trace>) {
+            ctx.tr << "  cannot reuse " << known.value << " with M = " << bits
+                   << ", searching\n";
+        }
+    }
+
+    std::size_t threads = 1;
+    (void)threads;
+
+    if constexpr (mp11::mp_contains<
+                      mp11::mp_list<Options...>, parallel_hash_search>::value) {
+        threads = search_threads(options);
+    }
+
     std::uniform_int_distribution<std::size_t> uniform_dist;
 
     for (std::size_t pass = 0; pass < 4; ++pass, ++M) {
         shift = 8 * sizeof(type_id) - M;
         auto hash_size = 1 << M;
-        min_value = (std::numeric_limits<std::size_t>::max)();
-        max_value = (std::numeric_limits<std::size_t>::min)();
 
         if constexpr (InitializeContext::template has_option<trace>) {
             ctx.tr << "  trying with M = " << M << ", " << hash_size
                    << " buckets\n";
         }
 
-        std::size_t attempts = 0;
         buckets.resize(hash_size);
 
-        while (attempts < 100000) {
-            std::fill(
-                buckets.begin(), buckets.end(), type_id(detail::uintptr_max));
-            ++attempts;
-            ++total_attempts;
-            mult = uniform_dist(rnd) | 1;
-
-            for (auto iter = ctx.classes_begin(); iter != ctx.classes_end();
-                 ++iter) {
-                for (auto type_iter = iter->type_id_begin();
-                     type_iter != iter->type_id_end(); ++type_iter) {
-                    auto type = *type_iter;
-                    auto index = (detail::uintptr(type) * mult) >> shift;
-                    min_value = (std::min)(min_value, index);
-                    max_value = (std::max)(max_value, index);
-
-                    if (detail::uintptr(buckets[index]) !=
-                        detail::uintptr_max) {
-                        goto collision;
+        if constexpr (mp11::mp_contains<
+                          mp11::mp_list<Options...>,
+                          parallel_hash_search>::value) {
+            if (threads > 1) {
+                if (search_parallel(
+                        ctx, buckets, threads, pass, total_attempts)) {
+                    if constexpr (InitializeContext::template has_option<
+                                      trace>) {
+                        ctx.tr << "  found " << mult << " after "
+                               << total_attempts << " attempts on " << threads
+                               << " threads; span = [" << min_value << ", "
+                               << max_value << "]\n";
                     }
 
-                    buckets[index] = type;
+                    return;
                 }
-            }
 
-            if constexpr (InitializeContext::template has_option<trace>) {
-                ctx.tr << "  found " << mult << " after " << total_attempts
-                       << " attempts; span = [" << min_value << ", "
-                       << max_value << "]\n";
+                continue;
             }
+        }
+
+        for (std::size_t attempts = 0; attempts < 100000; ++attempts) {
+            ++total_attempts;
+            mult = uniform_dist(rnd) | 1;
 
-            return;
+            if (try_factors(ctx, buckets, mult, shift, min_value, max_value)) {
+                if constexpr (InitializeContext::template has_option<trace>) {
+                    ctx.tr << "  found " << mult << " after " << total_attempts
+                           << " attempts; span = [" << min_value << ", "
+                           << max_value << "]\n";
+                }
 
-        collision: {}
+                return;
+            }
         }
     }
 
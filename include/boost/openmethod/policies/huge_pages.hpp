@@ -0,0 +1,165 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_HUGE_PAGES_HPP
+#define BOOST_OPENMETHOD_POLICY_HUGE_PAGES_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace boost::openmethod::policies {
+
+//! How a block allocated by @ref huge_pages is backed.
+enum class page_backing {
+    free_store,
+    explicit_huge_pages,
+    transparent_huge_pages
+};
+
+//! Back the dispatch data with huge pages.
+//!
+//! `huge_pages` implements the @ref memory policy. On Linux, blocks of at
+//! least `MinSize` bytes are mapped with `mmap`, using explicit 2 MB huge pages
+//! (`MAP_HUGETLB`) if the system has reserved some, or transparent huge pages
+//! (`madvise(MADV_HUGEPAGE)`) otherwise. If neither is available, or on other
+//! platforms, memory is obtained from the free store.
+//!
+//! Huge pages reduce the number of TLB misses when dispatching through large
+//! sets of v-tables and dispatch tables.
+//!
+//! @tparam MinSize The size, in bytes, below which memory is obtained from the
+//! free store.
+template<std::size_t MinSize = 256 * 1024>
+struct huge_pages : memory {
+    //! Size of a huge page.
+    static constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+    //! A MemoryFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    struct fn {
+        //! Allocates memory.
+        //!
+        //! @param bytes The number of bytes to allocate.
+        //! @return A pointer to a block of at least `bytes` bytes, aligned on a
+        //! 64 byte boundary.
+        static auto allocate(std::size_t bytes) -> void*;
+
+        //! Releases memory allocated by `allocate`.
+        //!
+        //! @param p A pointer returned by `allocate`.
+        //! @param bytes The number of bytes passed to `allocate`.
+        static auto deallocate(void* p, std::size_t bytes) -> void;
+
+        //! Returns how a block was allocated.
+        //!
+        //! @param p A pointer returned by `allocate`.
+        //! @return The @ref page_backing of the block.
+        static auto backing_of(const void* p) -> page_backing;
+
+      private:
+        // Each block starts with a header, padded to keep the data aligned on
+        // a cache line.
+        struct alignas(64) header {
+            std::size_t length;
+            page_backing kind;
+        };
+    };
+};
+
+template<std::size_t MinSize>
+template<class Registry>
+auto huge_pages<MinSize>::fn<Registry>::allocate(std::size_t bytes) -> void* {
+    auto length = sizeof(header) + bytes;
+
+#if defined(__linux__)
+    if (bytes >= MinSize) {
+        length = (length + huge_page_size - 1) / huge_page_size * huge_page_size;
+        void* block = MAP_FAILED;
+        auto kind = page_backing::explicit_huge_pages;
+
+#if defined(MAP_HUGETLB)
+        block = mmap(
+            nullptr, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+        if (block == MAP_FAILED) {
+            // Map one extra huge page, then trim the mapping so it starts on a
+            // huge page boundary, as required by transparent huge pages.
+            kind = page_backing::transparent_huge_pages;
+            auto extra = mmap(
+                nullptr, length + huge_page_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (extra != MAP_FAILED) {
+                auto first = reinterpret_cast<std::uintptr_t>(extra);
+                auto aligned = (first + huge_page_size - 1) / huge_page_size *
+                    huge_page_size;
+
+                if (aligned != first) {
+                    munmap(extra, aligned - first);
+                }
+
+                munmap(
+                    reinterpret_cast<void*>(aligned + length),
+                    first + huge_page_size - aligned);
+                block = reinterpret_cast<void*>(aligned);
+
+#if defined(MADV_HUGEPAGE)
+                // Failure is not an error: the pages are just not huge.
+                madvise(block, length, MADV_HUGEPAGE);
+#endif
+            }
+        }
+
+        if (block != MAP_FAILED) {
+            auto h = new (block) header{length, kind};
+
+            return h + 1;
+        }
+    }
+#endif
+
+    auto h = new (::operator new(length, std::align_val_t(alignof(header))))
+        header{length, page_backing::free_store};
+
+    return h + 1;
+}
+
+template<std::size_t MinSize>
+template<class Registry>
+auto huge_pages<MinSize>::fn<Registry>::deallocate(void* p, std::size_t)
+    -> void {
+    auto h = static_cast<header*>(p) - 1;
+
+#if defined(__linux__)
+    if (h->kind != page_backing::free_store) {
+        munmap(h, h->length);
+
+        return;
+    }
+#endif
+
+    ::operator delete(h, std::align_val_t(alignof(header)));
+}
+
+template<std::size_t MinSize>
+template<class Registry>
+auto huge_pages<MinSize>::fn<Registry>::backing_of(const void* p)
+    -> page_backing {
+    return (static_cast<const header*>(p) - 1)->kind;
+}
+
+} // namespace boost::openmethod::policies
+
+#endif
@@ -0,0 +1,162 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_ITANIUM_DOWNCAST_HPP
+#define BOOST_OPENMETHOD_POLICY_ITANIUM_DOWNCAST_HPP
+
+#include <boost/openmethod/preamble.hpp>
+#include <boost/openmethod/detail/vtbl_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#if !defined(__GXX_ABI_VERSION)
+#error "itanium_downcast requires the Itanium C++ ABI"
+#endif
+
+namespace boost::openmethod {
+
+namespace policies {
+
+//! Casts from virtual bases using offsets learnt from the C++ v-tables.
+//!
+//! `itanium_downcast` implements the @ref downcast policy. It relies on a
+//! property of the Itanium C++ ABI, used by GCC and Clang on most platforms:
+//! every subobject of a polymorphic class starts with a pointer to a C++
+//! v-table, which is specific to the position of the subobject in its complete
+//! object's class. Thus, the distance between a virtual base subobject and a
+//! derived subobject is the same for all the objects in which the base
+//! subobject has the same C++ v-table.
+//!
+//! For each pair of base and derived classes, the policy keeps a small,
+//! lock-free table of distances, keyed by C++ v-table address. A hit costs one
+//! load from the object, one multiplication, two loads from the table, and an
+//! addition. On a miss, the object is cast using the registry's @ref rtti
+//! policy's `dynamic_cast_ref`, and the distance is added to the table for
+//! later calls. Casts that find the table full use `dynamic_cast_ref`
+//! directly.
+//!
+//! The distances depend only on the layout of the classes, so they remain
+//! valid after a call to @ref initialize. They are forgotten by @ref finalize,
+//! which must be called before unloading a shared library that contains
+//! classes used in casts.
+struct itanium_downcast : downcast {
+    //! A DowncastFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    class fn {
+        using cache_type = detail::vtbl_cache<std::ptrdiff_t>;
+
+        // Number of slots per pair of classes, i.e. number of dynamic classes
+        // for which a cast is fast.
+        static constexpr std::size_t bits = 5;
+        static constexpr std::size_t size = std::size_t(1) << bits;
+
+        template<class Derived, class Base>
+        struct table {
+            static inline typename cache_type::slot slots[size];
+            static inline bool listed = false;
+
+            static auto cache() -> cache_type {
+                return {slots, 64 - bits, size - 1, size};
+            }
+
+            static auto reset() -> void {
+                cache().clear();
+                listed = false;
+            }
+        };
+
+        // The tables that contain distances, for `finalize`.
+        static inline std::mutex mutex;
+        static inline std::vector<void (*)()> tables;
+
+        template<class D, class B>
+        static auto learn(B&& obj, const void* key) -> D;
+
+      public:
+        //! Casts an object from a virtual base to a derived class.
+        //!
+        //! Looks up the address of the object's C++ v-table in the table for
+        //! `B` and `D`. If it is found, adjusts the address of `obj` by the
+        //! corresponding distance. Otherwise, casts `obj` using the registry's
+        //! @ref rtti policy, and adds the distance to the table.
+        //!
+        //! @tparam D A reference to a subclass of `B`.
+        //! @tparam B A polymorphic registered class.
+        //! @param obj A reference to an instance of `B`.
+        //! @return A reference to the same object, cast to `D`.
+        template<class D, class B>
+        static auto dynamic_cast_ref(B&& obj) -> D {
+            using Base = std::remove_reference_t<B>;
+            using Derived = std::remove_reference_t<D>;
+
+            static_assert(std::is_polymorphic_v<Base>);
+
+            auto address =
+                reinterpret_cast<std::uintptr_t>(std::addressof(obj));
+            auto key = *reinterpret_cast<const void* const*>(address);
+            using Table =
+                table<std::remove_cv_t<Derived>, std::remove_cv_t<Base>>;
+
+            if (auto offset = Table::cache().find(key)) {
+                return static_cast<D>(*reinterpret_cast<Derived*>(
+                    address + std::uintptr_t(*offset)));
+            }
+
+            return learn<D>(std::forward<B>(obj), key);
+        }
+
+        //! Forgets the distances learnt so far.
+        //!
+        //! @tparam Options... Zero or more option types.
+        //! @param options A tuple of option objects.
+        template<class... Options>
+        static auto finalize(const std::tuple<Options...>&) -> void {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (auto reset : tables) {
+                reset();
+            }
+
+            tables.clear();
+        }
+    };
+};
+
+template<class Registry>
+template<class D, class B>
+auto itanium_downcast::fn<Registry>::learn(B&& obj, const void* key) -> D {
+    using Base = std::remove_reference_t<B>;
+    using Derived = std::remove_reference_t<D>;
+    using Table = table<std::remove_cv_t<Derived>, std::remove_cv_t<Base>>;
+
+    auto address = reinterpret_cast<std::uintptr_t>(std::addressof(obj));
+    auto&& result =
+        Registry::rtti::template dynamic_cast_ref<D>(std::forward<B>(obj));
+    auto offset = std::ptrdiff_t(
+        reinterpret_cast<std::uintptr_t>(std::addressof(result)) - address);
+
+    if (Table::cache().insert(key, offset)) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!Table::listed) {
+            Table::listed = true;
+            tables.push_back(Table::reset);
+        }
+    }
+
+    return static_cast<D>(result);
+}
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,224 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_ITANIUM_VPTR_HPP
+#define BOOST_OPENMETHOD_POLICY_ITANIUM_VPTR_HPP
+
+#include <boost/openmethod/preamble.hpp>
+#include <boost/openmethod/detail/vtbl_cache.hpp>
+
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#if !defined(__GXX_ABI_VERSION)
+#error "itanium_vptr requires the Itanium C++ ABI"
+#endif
+
+namespace boost::openmethod {
+
+namespace policies {
+
+//! Finds v-table pointers from the address of the objects' C++ v-tables.
+//!
+//! `itanium_vptr` relies on a property of the Itanium C++ ABI, used by GCC and
+//! Clang on most platforms: every subobject of a polymorphic class starts with
+//! a pointer to a C++ v-table, and each C++ v-table belongs to a single dynamic
+//! class. It uses that pointer as the key of a small, lock-free hash table of
+//! the registry's v-table pointers. A hit costs one load from the object, one
+//! multiplication, and two independent loads from the same table entry: its
+//! key and its v-table pointer. The registry's @ref rtti policy is not
+//! involved.
+//!
+//! C++ v-table addresses are not known before objects are created. On a miss,
+//! the dynamic type of the object is acquired using the registry's @ref rtti
+//! policy, its v-table pointer is looked up in a map keyed by `type_id`, and
+//! the C++ v-table address is added to the table for later calls. Thus, the
+//! policy works with any @ref rtti policy that provides `dynamic_type`,
+//! including custom ones used in programs compiled without RTTI support.
+//!
+//! Classes that are not polymorphic, and calls that find the table full, use
+//! the map directly.
+//!
+//! In a registry that contains @ref indirect_vptr, the table holds pointers
+//! to the per-class v-table pointers instead, which remain valid across calls
+//! to @ref initialize. A hit then costs a third load.
+//!
+//! @note Linkers that fold identical read-only data may merge the v-tables of
+//! classes that do not override any virtual function, in programs compiled
+//! without RTTI support. Such classes must not have different overriders.
+struct itanium_vptr : vptr {
+    //! A VptrFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    class fn {
+        static_assert(
+            !Registry::has_replication,
+            "itanium_vptr does not support replication");
+
+        // The v-table pointer, or, in indirect registries, a pointer to it.
+        using value_type = std::conditional_t<
+            Registry::has_indirect_vptr, const vptr_type*, vptr_type>;
+
+        using cache_type = detail::vtbl_cache<value_type>;
+
+        // Number of slots probed before giving up.
+        static constexpr std::size_t max_probes = 8;
+
+        static inline std::unordered_map<type_id, const vptr_type*> vptrs;
+        static inline std::unique_ptr<typename cache_type::slot[]> slots;
+        static inline cache_type cache;
+
+        static auto deref(const value_type& value) -> const vptr_type& {
+            if constexpr (Registry::has_indirect_vptr) {
+                return *value;
+            } else {
+                return value;
+            }
+        }
+
+        static auto find(type_id type) -> const vptr_type*;
+
+        template<class Class>
+        static auto learn(const Class& arg, const void* key)
+            -> const vptr_type&;
+
+      public:
+        //! Stores the v-table pointers.
+        //!
+        //! Builds a map from `type_id`s to pointers to v-table pointers, and
+        //! empties the C++ v-table address table, sizing it for the number of
+        //! registered classes.
+        //!
+        //! @tparam Context An @ref InitializeContext.
+        //! @tparam Options... Zero or more option types.
+        //! @param ctx A Context object.
+        //! @param options A tuple of option objects.
+        template<class Context, class... Options>
+        static auto initialize(const Context& ctx, const std::tuple<Options...>&)
+            -> void {
+            decltype(vptrs) new_vptrs;
+
+            for (auto iter = ctx.classes_begin(); iter != ctx.classes_end();
+                 ++iter) {
+                for (auto type_iter = iter->type_id_begin();
+                     type_iter != iter->type_id_end(); ++type_iter) {
+                    new_vptrs.emplace(*type_iter, &iter->vptr());
+                }
+            }
+
+            // Leave room for the secondary v-tables of classes with several
+            // bases.
+            std::size_t bits = 6;
+
+            while ((std::size_t(1) << bits) < 4 * new_vptrs.size()) {
+                ++bits;
+            }
+
+            vptrs.swap(new_vptrs);
+            slots.reset(new typename cache_type::slot[std::size_t(1) << bits]);
+            cache = {
+                slots.get(), 64 - bits, (std::size_t(1) << bits) - 1,
+                max_probes};
+        }
+
+        //! Returns a *reference* to a v-table pointer for an object.
+        //!
+        //! If `Class` is polymorphic, looks up the address of the object's C++
+        //! v-table in a table. If it is not found, acquires the dynamic
+        //! @ref type_id of `arg` using the registry's @ref rtti policy, finds
+        //! the v-table pointer in a map, and adds the C++ v-table address to
+        //! the table.
+        //!
+        //! If the registry contains the @ref runtime_checks policy, checks that
+        //! the map contains the type id. If it does not, and if the registry
+        //! contains a @ref error_handler policy, calls its @ref error function
+        //! with a @ref missing_class value, then terminates the program with
+        //! @ref abort.
+        //!
+        //! @tparam Class A registered class.
+        //! @param arg A reference to a const object of type `Class`.
+        //! @return A reference to a the v-table pointer for `Class`.
+        template<class Class>
+        static auto dynamic_vptr(const Class& arg) -> const vptr_type& {
+            if constexpr (std::is_polymorphic_v<Class>) {
+                auto key = *reinterpret_cast<const void* const*>(
+                    std::addressof(arg));
+
+                if (auto value = cache.find(key)) {
+                    return deref(*value);
+                }
+
+                return learn(arg, key);
+            } else {
+                return *find(Registry::rtti::dynamic_type(arg));
+            }
+        }
+
+        //! Returns a *reference* to the v-table pointer for a type.
+        //!
+        //! Looks up the `type_id` in the map. Performs the same checks as
+        //! @ref dynamic_vptr.
+        //!
+        //! @param type The `type_id` of a registered class.
+        //! @return A reference to a the v-table pointer for the class.
+        static auto type_vptr(type_id type) -> const vptr_type& {
+            return *find(type);
+        }
+
+        //! Releases the memory allocated by `initialize`.
+        //!
+        //! @tparam Options... Zero or more option types.
+        //! @param options A tuple of option objects.
+        template<class... Options>
+        static auto finalize(const std::tuple<Options...>&) -> void {
+            vptrs.clear();
+            cache = {};
+            slots.reset();
+        }
+    };
+};
+
+template<class Registry>
+auto itanium_vptr::fn<Registry>::find(type_id type) -> const vptr_type* {
+    auto iter = vptrs.find(type);
+
+    if constexpr (Registry::has_runtime_checks) {
+        if (iter == vptrs.end()) {
+            if constexpr (Registry::has_error_handler) {
+                missing_class error;
+                error.type = type;
+                Registry::error_handler::error(error);
+            }
+
+            abort();
+        }
+    }
+
+    // check for valid iterator is done if runtime_checks is enabled
+    // coverity[deref_iterator:SUPPRESS]
+    return iter->second;
+}
+
+template<class Registry>
+template<class Class>
+auto itanium_vptr::fn<Registry>::learn(const Class& arg, const void* key)
+    -> const vptr_type& {
+    auto vptr = find(Registry::rtti::dynamic_type(arg));
+
+    if constexpr (Registry::has_indirect_vptr) {
+        cache.insert(key, vptr);
+    } else {
+        cache.insert(key, *vptr);
+    }
+
+    return *vptr;
+}
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#endif
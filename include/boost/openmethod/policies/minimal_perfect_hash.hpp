@@ -0,0 +1,449 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_MINIMAL_PERFECT_HASH_HPP
+#define BOOST_OPENMETHOD_POLICY_MINIMAL_PERFECT_HASH_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <cstdint>
+#include <random>
+#include <variant>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4702) // unreachable code
+#endif
+
+namespace boost::openmethod {
+
+namespace detail {
+
+template<class Registry>
+std::vector<type_id> minimal_perfect_hash_control;
+
+} // namespace detail
+
+namespace policies {
+
+//! Hash type ids using a minimal perfect hash function.
+//!
+//! `minimal_perfect_hash` implements the @ref type_hash policy using a
+//! hash-and-displace function, in the style of the CHD algorithm. For `N`
+//! type_ids, it uses `N/4` to `N/2` buckets, each holding a 32-bit
+//! displacement. The hash of `x` is computed as:
+//!
+//! @code
+//! z = M * x
+//! y = M * (z ^ (z >> 32))
+//! H(x) = (((low(y) ^ D[high(y)]) * C mod 2^32) * N) >> 32
+//! @endcode
+//!
+//! ...where `high(y)` are the high bits of `y`, used as the bucket index,
+//! `low(y)` the next 32 bits, and `C` a fixed odd constant.
+//!
+//! Unlike @ref fast_perfect_hash, the hash values form the dense range `[0,
+//! N)`, so no space is wasted in the @ref vptr_vector. The search runs in
+//! expected linear time and, in practice, always succeeds: it fails only if
+//! the same type_id is registered for two classes.
+struct minimal_perfect_hash : type_hash {
+
+    //! Cannot find a minimal perfect hash function
+    struct search_error : openmethod_error {
+        //! Number of multipliers tried
+        std::size_t attempts;
+        //! Number of type_ids to hash
+        std::size_t types;
+
+        //! Write a short description to an output stream
+        //! @param os The output stream
+        //! @tparam Registry The registry
+        //! @tparam Stream A @ref LightweightOutputStream
+        template<class Registry, class Stream>
+        auto write(Stream& os) const -> void;
+    };
+
+    using errors = std::variant<search_error>;
+
+    //! A TypeHashFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy
+    template<class Registry>
+    class fn {
+        static std::uint64_t mult;
+        static std::size_t bucket_shift;
+        static std::size_t low_shift;
+        static std::size_t size;
+        static std::vector<std::uint32_t> displacements;
+
+        static void check(std::size_t index, type_id type);
+
+        // Odd multiplier, and its inverse modulo 2^32.
+        static constexpr std::uint32_t mix = 0x9E3779B9u;
+        static constexpr std::uint32_t unmix = 0x144CBC89u;
+        static_assert(std::uint32_t(mix * unmix) == 1);
+
+        // Mix 32 bits, then map them to [0, size). The multiplication spreads
+        // the low bits of `bits` to the high bits, which select the slot.
+        BOOST_FORCEINLINE
+        static auto reduce(std::uint32_t bits) -> std::size_t {
+            return std::size_t(
+                (std::uint64_t(std::uint32_t(bits * mix)) * size) >> 32);
+        }
+
+        // Scramble a type_id. Type_ids are often laid out at regular
+        // intervals, which a single multiplication maps to buckets of
+        // near-equal sizes; folding the high bits into the low bits, then
+        // multiplying again, makes them look random.
+        BOOST_FORCEINLINE
+        static auto scramble(std::uint64_t x) -> std::uint64_t {
+            auto y = mult * x;
+
+            return mult * (y ^ (y >> 32));
+        }
+
+        BOOST_FORCEINLINE
+        static auto hash_value(type_id type) -> std::size_t {
+            auto y =
+                scramble(std::uint64_t(reinterpret_cast<std::uintptr_t>(type)));
+
+            return reduce(
+                std::uint32_t(y >> low_shift) ^
+                displacements[std::size_t(y >> bucket_shift)]);
+        }
+
+        template<class InitializeContext, class... Options>
+        static void initialize(
+            const InitializeContext& ctx, std::vector<type_id>& control,
+            const std::tuple<Options...>& options);
+
+      public:
+        //! Find the hash function
+        //!
+        //! Finds a multiplier `M` and a displacement for each bucket, such
+        //! that the hash function maps the registered type_ids to `[0, N)`
+        //! without collisions.
+        //!
+        //! If the same type_id is registered for several classes, calls the
+        //! error handler with a @ref search_error object then calls `abort`.
+        //!
+        //! @tparam Context An @ref InitializeContext.
+        //! @param ctx A Context object.
+        //! @return A pair containing the minimum and maximum hash values.
+        template<class Context, class... Options>
+        static auto
+        initialize(const Context& ctx, const std::tuple<Options...>& options) {
+            if constexpr (Registry::has_runtime_checks) {
+                initialize(
+                    ctx, detail::minimal_perfect_hash_control<Registry>,
+                    options);
+            } else {
+                std::vector<type_id> control;
+                initialize(ctx, control, options);
+            }
+
+            return std::pair{std::size_t(0), size ? size - 1 : 0};
+        }
+
+        //! Hash a type id
+        //!
+        //! Hash a type id.
+        //!
+        //! If `Registry` contains the @ref runtime_checks policy, checks that
+        //! the type id is valid, i.e. if it was present in the set passed to
+        //! @ref initialize. Its absence indicates that a class involved in a
+        //! method definition, method overrider, or method call was not
+        //! registered. In this case, signal a @ref missing_class using
+        //! the registry's @ref error_handler if present; then calls `abort`.
+        //!
+        //! @param type The type_id to hash
+        //! @return The hash value
+        BOOST_FORCEINLINE
+        static auto hash(type_id type) -> std::size_t {
+            auto index = hash_value(type);
+
+            if constexpr (Registry::has_runtime_checks) {
+                check(index, type);
+            }
+
+            return index;
+        }
+
+        //! Hash a type id, without checking it
+        //!
+        //! Hash a type id, even if `Registry` contains the @ref
+        //! runtime_checks policy. Used by @ref vptr_vector, which performs
+        //! the check itself.
+        //!
+        //! @param type The type_id to hash
+        //! @return The hash value
+        BOOST_FORCEINLINE
+        static auto unchecked_hash(type_id type) -> std::size_t {
+            return hash_value(type);
+        }
+
+        //! Releases the memory allocated by `initialize`.
+        //!
+        //! @tparam Options... Zero or more option types, deduced from the function
+        //! arguments.
+        //! @param options Zero or more option objects.
+        template<class... Options>
+        static auto finalize(const std::tuple<Options...>&) -> void {
+            detail::minimal_perfect_hash_control<Registry>.clear();
+            displacements.clear();
+            size = 0;
+        }
+    };
+};
+
+template<class Registry>
+std::uint64_t minimal_perfect_hash::fn<Registry>::mult;
+
+template<class Registry>
+std::size_t minimal_perfect_hash::fn<Registry>::bucket_shift;
+
+template<class Registry>
+std::size_t minimal_perfect_hash::fn<Registry>::low_shift;
+
+template<class Registry>
+std::size_t minimal_perfect_hash::fn<Registry>::size;
+
+template<class Registry>
+std::vector<std::uint32_t> minimal_perfect_hash::fn<Registry>::displacements;
+
+template<class Registry>
+template<class InitializeContext, class... Options>
+void minimal_perfect_hash::fn<Registry>::initialize(
+    const InitializeContext& ctx, std::vector<type_id>& control,
+    const std::tuple<Options...>& options) {
+    (void)options;
+
+    std::vector<std::uint64_t> keys;
+
+    for (auto iter = ctx.classes_begin(); iter != ctx.classes_end(); ++iter) {
+        for (auto type_iter = iter->type_id_begin();
+             type_iter != iter->type_id_end(); ++type_iter) {
+            keys.push_back(reinterpret_cast<std::uintptr_t>(*type_iter));
+        }
+    }
+
+    const auto N = keys.size();
+
+    if constexpr (InitializeContext::template has_option<trace>) {
+        ctx.tr << "Finding minimal perfect hash for " << N << " types\n";
+    }
+
+    // Use two to four type_ids per bucket, and at least two buckets, so the
+    // shifts stay within [1, 63].
+    std::size_t bits = 1;
+
+    while ((std::size_t(1) << bits) < N / 4) {
+        ++bits;
+    }
+
+    const auto buckets = std::size_t(1) << bits;
+    size = N;
+    bucket_shift = 64 - bits;
+    low_shift = 32 - bits;
+
+    std::default_random_engine rnd(13081963);
+    std::uniform_int_distribution<std::uint64_t> uniform_dist;
+
+    // Type_ids grouped by bucket: `first[b]` is the index, in `low`, of the
+    // first type_id in bucket `b`.
+    std::vector<std::size_t> first(buckets + 1);
+    std::vector<std::uint32_t> low(N);
+    // Buckets, largest first.
+    std::vector<std::size_t> order(buckets), by_size;
+    std::vector<std::size_t> free_slots;
+    std::vector<bool> taken(N);
+
+    for (std::size_t attempts = 1; attempts <= 100; ++attempts) {
+        mult = uniform_dist(rnd) | 1;
+
+        // Counting sort of the type_ids by bucket.
+        std::fill(first.begin(), first.end(), 0);
+
+        for (auto key : keys) {
+            ++first[std::size_t(scramble(key) >> bucket_shift) + 1];
+        }
+
+        std::size_t largest = 0;
+
+        for (std::size_t b = 0; b < buckets; ++b) {
+            largest = (std::max)(largest, first[b + 1]);
+            first[b + 1] += first[b];
+        }
+
+        {
+            auto next = first;
+
+            for (auto key : keys) {
+                auto y = scramble(key);
+                low[next[std::size_t(y >> bucket_shift)]++] =
+                    std::uint32_t(y >> low_shift);
+            }
+        }
+
+        // Counting sort of the buckets by decreasing size.
+        by_size.assign(largest + 2, 0);
+
+        for (std::size_t b = 0; b < buckets; ++b) {
+            ++by_size[largest - (first[b + 1] - first[b]) + 1];
+        }
+
+        for (std::size_t s = 0; s <= largest; ++s) {
+            by_size[s + 1] += by_size[s];
+        }
+
+        for (std::size_t b = 0; b < buckets; ++b) {
+            order[by_size[largest - (first[b + 1] - first[b])]++] = b;
+        }
+
+        displacements.assign(buckets, 0);
+        taken.assign(N, false);
+
+        // Try displacements derived from a Weyl sequence, until the type_ids
+        // in the bucket all land in free slots.
+        auto place = [&](std::size_t b) {
+            for (std::uint64_t k = 0; k < 65536; ++k) {
+                auto d = std::uint32_t((k * 0x9E3779B97F4A7C15ull) >> 32);
+                auto fits = true;
+
+                for (auto i = first[b]; fits && i < first[b + 1]; ++i) {
+                    auto index = reduce(low[i] ^ d);
+                    fits = !taken[index];
+                    taken[index] = true;
+
+                    if (!fits) {
+                        // Undo the type_ids placed so far.
+                        while (i-- > first[b]) {
+                            taken[reduce(low[i] ^ d)] = false;
+                        }
+
+                        break;
+                    }
+                }
+
+                if (fits) {
+                    displacements[b] = d;
+
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        // Place the buckets with several type_ids first, while the table is
+        // still sparse.
+        std::size_t bucket_iter = 0;
+        auto placed = true;
+
+        for (; bucket_iter < buckets; ++bucket_iter) {
+            auto b = order[bucket_iter];
+
+            if (first[b + 1] - first[b] < 2) {
+                break;
+            }
+
+            if (!place(b)) {
+                placed = false;
+                break;
+            }
+        }
+
+        if (!placed) {
+            if constexpr (InitializeContext::template has_option<trace>) {
+                ctx.tr << "  multiplier " << mult << " failed\n";
+            }
+
+            continue;
+        }
+
+        // Each remaining bucket has at most one type_id: send it straight to a
+        // free slot.
+        free_slots.clear();
+
+        for (std::size_t index = 0; index < N; ++index) {
+            if (!taken[index]) {
+                free_slots.push_back(index);
+            }
+        }
+
+        auto free_iter = free_slots.begin();
+
+        for (; bucket_iter < buckets; ++bucket_iter) {
+            auto b = order[bucket_iter];
+
+            if (first[b] == first[b + 1]) {
+                break;
+            }
+
+            // The smallest value that `reduce` maps to the free slot, after
+            // mixing.
+            auto target = std::uint32_t(
+                ((std::uint64_t(*free_iter++) << 32) + N - 1) / N);
+            displacements[b] = low[first[b]] ^ std::uint32_t(target * unmix);
+        }
+
+        control.assign(N, type_id(0));
+
+        for (auto key : keys) {
+            auto type = type_id(std::uintptr_t(key));
+            control[hash_value(type)] = type;
+        }
+
+        if constexpr (InitializeContext::template has_option<trace>) {
+            ctx.tr << "  found " << mult << " after " << attempts
+                   << " attempts; " << buckets << " buckets, " << N
+                   << " slots\n";
+        }
+
+        return;
+    }
+
+    search_error error;
+    error.attempts = 100;
+    error.types = N;
+
+    if constexpr (Registry::has_error_handler) {
+        Registry::error_handler::error(error);
+    }
+
+    abort();
+}
+
+template<class Registry>
+void minimal_perfect_hash::fn<Registry>::check(
+    std::size_t index, type_id type) {
+    if (index >= detail::minimal_perfect_hash_control<Registry>.size() ||
+        detail::minimal_perfect_hash_control<Registry>[index] != type) {
+
+        if constexpr (Registry::has_error_handler) {
+            missing_class error;
+            error.type = type;
+            Registry::error_handler::error(error);
+        }
+
+        abort();
+    }
+}
+
+template<class Registry, class Stream>
+auto minimal_perfect_hash::search_error::write(Stream& os) const -> void {
+    os << "could not find a minimal perfect hash for " << types
+       << " types after " << attempts << " attempts (duplicate type_ids?)\n";
+}
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
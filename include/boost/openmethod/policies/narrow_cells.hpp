@@ -0,0 +1,102 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_NARROW_CELLS_HPP
+#define BOOST_OPENMETHOD_POLICY_NARROW_CELLS_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4702) // unreachable code
+#endif
+
+namespace boost::openmethod::policies {
+
+//! Too many overriders to be indexed by the cells of a dispatch table.
+struct too_many_overriders : openmethod_error {
+    //! The type_id of the method.
+    type_id method;
+    //! The number of function pointers that need an index.
+    std::size_t functions;
+    //! The number of function pointers that a cell can index.
+    std::size_t capacity;
+
+    //! Write a short description to an output stream
+    //! @param os The output stream
+    //! @tparam Registry The registry
+    //! @tparam Stream A @ref LightweightOutputStream
+    template<class Registry, class Stream>
+    auto write(Stream& os) const -> void {
+        os << "too many overriders in ";
+        Registry::rtti::type_name(method, os);
+        os << ": " << functions << " functions, cells can index " << capacity;
+    }
+};
+
+//! Store narrow indexes in multi-method dispatch tables.
+//!
+//! `narrow_cells` makes multi-method dispatch tables contain `CellType`
+//! indexes into a per-method array of function pointers. With the default
+//! `std::uint16_t`, the tables are four times smaller than with full pointers
+//! on 64-bit platforms, at the cost of one extra memory read per call.
+//!
+//! @tparam CellType An unsigned integer type.
+template<typename CellType = std::uint16_t>
+struct narrow_cells : compact_tables {
+    static_assert(
+        std::is_unsigned_v<CellType>, "CellType must be an unsigned integer");
+
+    //! The errors that this policy may report.
+    using errors = std::variant<too_many_overriders>;
+
+    //! A CompactTablesFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    struct fn {
+        //! The type of the dispatch table cells.
+        using cell_type = CellType;
+
+        //! Checks that the overriders of a method can be indexed by `CellType`.
+        //!
+        //! If `functions` exceeds the number of values of `CellType`, calls
+        //! the registry's @ref error_handler if present, with a @ref
+        //! too_many_overriders object; then calls `abort`.
+        //!
+        //! @param method The @ref type_id of the method.
+        //! @param functions The number of function pointers to index.
+        static auto check(type_id method, std::size_t functions) -> void {
+            constexpr auto max_index =
+                std::size_t((std::numeric_limits<CellType>::max)());
+
+            if (functions == 0 || functions - 1 <= max_index) {
+                return;
+            }
+
+            if constexpr (Registry::has_error_handler) {
+                too_many_overriders error;
+                error.method = method;
+                error.functions = functions;
+                error.capacity = max_index + 1;
+                Registry::error_handler::error(error);
+            }
+
+            abort();
+        }
+    };
+};
+
+} // namespace boost::openmethod::policies
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
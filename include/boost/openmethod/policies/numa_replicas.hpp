@@ -0,0 +1,170 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_NUMA_REPLICAS_HPP
+#define BOOST_OPENMETHOD_POLICY_NUMA_REPLICAS_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace boost::openmethod {
+
+namespace detail {
+
+// Linux memory policy for mbind(2), from <numaif.h>.
+constexpr int mpol_preferred = 1;
+
+// Returns the number of NUMA nodes, or 1 if it cannot be determined.
+inline auto numa_node_count() -> std::size_t {
+    std::size_t nodes = 0;
+
+#if defined(__linux__)
+    // mbind masks are limited to one word in this implementation.
+    while (nodes < 8 * sizeof(unsigned long)) {
+        auto path =
+            "/sys/devices/system/node/node" + std::to_string(nodes);
+
+        if (access(path.c_str(), F_OK) != 0) {
+            break;
+        }
+
+        ++nodes;
+    }
+#endif
+
+    return nodes ? nodes : 1;
+}
+
+// Returns the NUMA node of the calling thread, or 0 if it cannot be
+// determined.
+inline auto current_numa_node() -> std::size_t {
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0, node = 0;
+
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return node;
+    }
+#endif
+
+    return 0;
+}
+
+} // namespace detail
+
+namespace policies {
+
+//! Replicate the dispatch data on each NUMA node.
+//!
+//! `numa_replicas` implements the @ref replication policy. It makes one
+//! replica of the dispatch data per NUMA node, and binds its memory to the
+//! node. Each thread dispatches through the replica of the node it runs on,
+//! as determined the first time it calls a method. Only @ref vptr_vector
+//! finds the v-table pointers in the thread's replica; the other @ref vptr
+//! policies reject replication.
+//!
+//! On machines with a single node, and on platforms other than Linux, there
+//! is a single replica: the dispatch data itself.
+//!
+//! @note Replica 0 is the dispatch data itself, which is not bound to a node.
+//! Threads that migrate to another node keep using the replica of their
+//! original node.
+struct numa_replicas : replication {
+    //! A ReplicationFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    struct fn {
+        //! Returns the number of NUMA nodes.
+        //!
+        //! @return The number of replicas to create.
+        static auto initialize() -> std::size_t {
+            nodes = detail::numa_node_count();
+
+            return nodes;
+        }
+
+        //! Allocates memory on a NUMA node.
+        //!
+        //! @param replica The index of the replica, also the node number.
+        //! @param bytes The number of bytes to allocate.
+        //! @return A pointer to a block of at least `bytes` bytes.
+        static auto allocate(std::size_t replica, std::size_t bytes) -> void* {
+#if defined(__linux__)
+            auto p = mmap(
+                nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+
+#if defined(SYS_mbind)
+            // Failure is not an error: the memory is just not bound.
+            unsigned long mask = 1ul << replica;
+            syscall(
+                SYS_mbind, p, bytes, detail::mpol_preferred, &mask,
+                8 * sizeof(mask) + 1, 0);
+#endif
+
+            return p;
+#else
+            (void)replica;
+
+            return ::operator new(bytes, std::align_val_t(64));
+#endif
+        }
+
+        //! Releases memory allocated by `allocate`.
+        //!
+        //! @param replica The index of the replica.
+        //! @param p A pointer returned by `allocate`.
+        //! @param bytes The number of bytes passed to `allocate`.
+        static auto deallocate(std::size_t replica, void* p, std::size_t bytes)
+            -> void {
+            (void)replica;
+
+#if defined(__linux__)
+            munmap(p, bytes);
+#else
+            (void)bytes;
+            ::operator delete(p, std::align_val_t(64));
+#endif
+        }
+
+        //! Returns the replica for the node of the calling thread.
+        //!
+        //! The node is determined on the first call, and cached in a
+        //! thread-local variable.
+        //!
+        //! @return A replica index.
+        static auto local_replica() -> std::size_t {
+            static thread_local std::size_t replica = unknown;
+
+            if (replica == unknown) {
+                auto node = detail::current_numa_node();
+                replica = node < nodes ? node : 0;
+            }
+
+            return replica;
+        }
+
+      private:
+        static constexpr std::size_t unknown = ~std::size_t(0);
+        static inline std::size_t nodes = 1;
+    };
+};
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,231 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_ORDINAL_RTTI_HPP
+#define BOOST_OPENMETHOD_POLICY_ORDINAL_RTTI_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#ifndef BOOST_NO_RTTI
+#include <typeinfo>
+#include <vector>
+#include <boost/core/demangle.hpp>
+#endif
+
+//! Declares the ordinal hook for @ref policies::ordinal_rtti.
+//!
+//! Must be used in the definition of each polymorphic class registered in a
+//! registry that uses @ref policies::ordinal_rtti. Expands to a virtual member
+//! function that returns the ordinal of the class. Registering a class that
+//! inherits the function, instead of declaring it, is a compile-time error.
+//!
+//! @param REGISTRY The registry.
+#define BOOST_OPENMETHOD_ORDINAL(REGISTRY)                                     \
+    virtual auto boost_openmethod_ordinal() const                              \
+        -> ::boost::openmethod::type_id {                                      \
+        return REGISTRY::rtti::template static_type<                           \
+            std::remove_cv_t<std::remove_pointer_t<decltype(this)>>>();        \
+    }
+
+namespace boost::openmethod {
+
+namespace detail {
+
+template<class Class, typename = void>
+constexpr bool has_ordinal_hook = false;
+
+template<class Class>
+constexpr bool has_ordinal_hook<
+    Class, std::void_t<decltype(std::declval<const Class&>()
+                                    .boost_openmethod_ordinal())>> = true;
+
+// True if the hook is declared in Class itself, not inherited from a base.
+template<class Class>
+constexpr bool declares_ordinal_hook = std::is_same_v<
+    decltype(&Class::boost_openmethod_ordinal), type_id (Class::*)() const>;
+
+} // namespace detail
+
+namespace policies {
+
+//! Identifies classes with dense, per-registry ordinals.
+//!
+//! `ordinal_rtti` implements the @ref rtti policy. It assigns ordinals 1, 2, 3,
+//! ... to the polymorphic classes of a registry, in the order in which they
+//! are first mentioned, typically by @ref use_classes. The ordinal is used as
+//! the `type_id`. Zero is not used, as some policies reserve the null
+//! `type_id`.
+//!
+//! The dynamic type of an object is obtained from a virtual function,
+//! declared in each class with the @ref BOOST_OPENMETHOD_ORDINAL macro. In a
+//! registry without a @ref type_hash policy, @ref vptr_vector then finds the
+//! v-table pointer with a single array access, and uses a vector with one
+//! entry per class.
+//!
+//! @note A class derived from a class that uses the macro must use it as well;
+//! otherwise, it would inherit the ordinal of its base, and `static_type`
+//! fails to compile. A registered class that has no ordinal at all is
+//! identified by an address; in a registry without a @ref type_hash,
+//! `initialize` reports it as a @ref missing_class.
+//!
+//! Other types, like method and function types, or polymorphic classes that
+//! do not use the macro, like `std::ostream`, are identified by the address of
+//! a static variable, so they do not use ordinals.
+//!
+//! If the program is compiled with RTTI support, class names are obtained
+//! from `typeid`, and `dynamic_cast` is used to cast from virtual bases.
+//! Otherwise, classes are named after their ordinals.
+//!
+//! @par Example
+//! @code
+//! struct my_registry : default_registry::with<ordinal_rtti>::without<
+//!     type_hash> {};
+//!
+//! struct Animal {
+//!     BOOST_OPENMETHOD_ORDINAL(my_registry);
+//!     virtual ~Animal() = default;
+//! };
+//!
+//! struct Dog : Animal {
+//!     BOOST_OPENMETHOD_ORDINAL(my_registry);
+//! };
+//! @endcode
+struct ordinal_rtti : rtti {
+    //! A RttiFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    struct fn : rtti::defaults {
+        //! Evaluates to `true` if `Class` uses @ref BOOST_OPENMETHOD_ORDINAL.
+        //!
+        //! @tparam Class A class.
+        template<class Class>
+        static constexpr bool is_polymorphic =
+            detail::has_ordinal_hook<Class>;
+
+        //! Returns the @ref type_id of `Class`.
+        //!
+        //! If `Class` uses @ref BOOST_OPENMETHOD_ORDINAL, returns its ordinal,
+        //! assigning the next one on the first call. Otherwise, returns the
+        //! address of a static variable. Fails to compile if `Class` inherits
+        //! the ordinal of a base class.
+        //!
+        //! @tparam Class A class.
+        template<class Class>
+        static auto static_type() -> type_id {
+            if constexpr (is_polymorphic<Class>) {
+                static_assert(
+                    detail::declares_ordinal_hook<Class>,
+                    "class inherits its ordinal; use BOOST_OPENMETHOD_ORDINAL "
+                    "in its definition");
+
+                static const auto ordinal = assign<Class>();
+
+                return type_id(ordinal);
+            } else {
+                static char id;
+
+                return &id;
+            }
+        }
+
+        //! Tests if a @ref type_id is an ordinal.
+        //!
+        //! A registry that uses @ref vptr_vector without a @ref type_hash
+        //! uses the `type_id`s of its classes as indices. It calls this
+        //! function to reject the classes that do not use @ref
+        //! BOOST_OPENMETHOD_ORDINAL.
+        //!
+        //! @param type A `type_id`.
+        //! @return `true` if `type` was assigned by this policy.
+        static auto is_ordinal(type_id type) -> bool {
+            auto ordinal = reinterpret_cast<std::uintptr_t>(type);
+
+            return ordinal != 0 && ordinal <= count;
+        }
+
+        //! Returns the @ref type_id of an object's dynamic type.
+        //!
+        //! If `Class` uses @ref BOOST_OPENMETHOD_ORDINAL, calls the object's
+        //! `boost_openmethod_ordinal` member function. Otherwise, returns
+        //! `static_type<Class>()`.
+        //!
+        //! @tparam Class A class.
+        //! @param obj A reference to an object.
+        template<class Class>
+        static auto dynamic_type(const Class& obj) -> type_id {
+            if constexpr (is_polymorphic<Class>) {
+                return obj.boost_openmethod_ordinal();
+            } else {
+                return static_type<Class>();
+            }
+        }
+
+        //! Writes a representation of a @ref type_id to a stream.
+        //!
+        //! @tparam Stream A @ref LightweightOutputStream.
+        //! @param type The `type_id`.
+        //! @param stream The stream to write to.
+        template<typename Stream>
+        static auto type_name(type_id type, Stream& stream) -> void {
+            if (!is_ordinal(type)) {
+                rtti::defaults::type_name(type, stream);
+
+                return;
+            }
+
+            auto ordinal = reinterpret_cast<std::uintptr_t>(type);
+
+#ifndef BOOST_NO_RTTI
+            stream << boost::core::demangle(names()[ordinal - 1]->name());
+#else
+            stream << "class #" << ordinal;
+#endif
+        }
+
+#ifndef BOOST_NO_RTTI
+        //! Casts from a virtual base using `dynamic_cast`.
+        //!
+        //! @tparam D The target type.
+        //! @tparam B The source type, deduced.
+        //! @param obj A reference to an object.
+        template<typename D, typename B>
+        static auto dynamic_cast_ref(B&& obj) -> D {
+            return dynamic_cast<D>(obj);
+        }
+#endif
+
+      private:
+        static inline std::size_t count = 0;
+
+#ifndef BOOST_NO_RTTI
+        // Function-local, so it is constructed before the static
+        // constructors that register classes use it.
+        static auto names() -> std::vector<const std::type_info*>& {
+            static std::vector<const std::type_info*> names;
+
+            return names;
+        }
+#endif
+
+        template<class Class>
+        static auto assign() -> std::uintptr_t {
+#ifndef BOOST_NO_RTTI
+            names().push_back(&typeid(Class));
+#endif
+
+            return ++count;
+        }
+    };
+};
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#endif
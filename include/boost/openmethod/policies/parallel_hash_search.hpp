@@ -0,0 +1,140 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_PARALLEL_HASH_SEARCH_HPP
+#define BOOST_OPENMETHOD_POLICY_PARALLEL_HASH_SEARCH_HPP
+
+#include <boost/openmethod/policies/fast_perfect_hash.hpp>
+
+#include <boost/mp11/tuple.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+namespace boost::openmethod {
+
+//! Search for hash factors on several threads.
+//!
+//! If `parallel_hash_search` is present in @ref initialize's `Options`,
+//! @ref policies::fast_perfect_hash splits the search for hash factors across
+//! `threads` threads. Each thread tests a disjoint stream of candidate
+//! multipliers, and the first one to succeed wins. The multiplier found may
+//! vary from one run to the next.
+//!
+//! This is useful for registries with tens of thousands of type_ids. For small
+//! registries, starting the threads costs more than the search itself.
+struct parallel_hash_search {
+    //! Number of threads; 0 means `std::thread::hardware_concurrency()`.
+    std::size_t threads = 0;
+};
+
+namespace policies {
+
+template<class Registry>
+template<class... Options>
+auto fast_perfect_hash::fn<Registry>::search_threads(
+    const std::tuple<Options...>& options) -> std::size_t {
+    std::size_t threads = 0;
+
+    mp11::tuple_for_each(options, [&threads](const auto& option) {
+        if constexpr (std::is_same_v<
+                          std::decay_t<decltype(option)>,
+                          parallel_hash_search>) {
+            threads = option.threads;
+        }
+    });
+
+    if (threads == 0) {
+        threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    return threads;
+}
+
+template<class Registry>
+template<class InitializeContext>
+auto fast_perfect_hash::fn<Registry>::search_parallel(
+    const InitializeContext& ctx, std::vector<type_id>& buckets,
+    std::size_t threads, std::size_t pass, std::size_t& attempts) -> bool {
+    std::atomic<bool> found(false);
+    std::atomic<std::size_t> tried(0);
+    std::mutex winner;
+    std::vector<std::thread> workers;
+    // The winner swaps its buckets into `buckets`, possibly before the other
+    // threads start.
+    const auto hash_size = buckets.size();
+
+    auto work = [&](std::size_t first) {
+        std::vector<type_id> local(hash_size);
+        std::size_t low, high;
+
+        // Thread `first` tests the candidates `first`, `first + threads`, ...
+        // Candidates are numbered from a different range in each pass.
+        for (auto k = first; !found.load(std::memory_order_relaxed);
+             k += threads) {
+            if (tried.fetch_add(1, std::memory_order_relaxed) >= 100000) {
+                break;
+            }
+
+            auto candidate = std::size_t(
+                detail::splitmix64((std::uint64_t(pass) << 32) + k) | 1);
+
+            if (try_factors(ctx, local, candidate, shift, low, high)) {
+                std::lock_guard<std::mutex> lock(winner);
+
+                if (!found.load(std::memory_order_relaxed)) {
+                    found.store(true, std::memory_order_relaxed);
+                    mult = candidate;
+                    min_value = low;
+                    max_value = high;
+                    buckets.swap(local);
+                }
+
+                break;
+            }
+        }
+    };
+
+    // If the calling thread leaves by an exception, stop the workers and join
+    // them, so their `std::thread` objects are not destroyed while joinable.
+    struct join_workers {
+        std::atomic<bool>& found;
+        std::vector<std::thread>& workers;
+
+        ~join_workers() {
+            for (auto& worker : workers) {
+                if (worker.joinable()) {
+                    found.store(true, std::memory_order_relaxed);
+                    worker.join();
+                }
+            }
+        }
+    } guard{found, workers};
+
+    try {
+        for (std::size_t thread = 1; thread < threads; ++thread) {
+            workers.emplace_back(work, thread);
+        }
+    } catch (const std::system_error&) {
+        // Search with the threads already started.
+    }
+
+    work(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    attempts += (std::min)(tried.load(), std::size_t(100000));
+
+    return found;
+}
+
+} // namespace policies
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,232 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_POLICY_STABLE_VTBLS_HPP
+#define BOOST_OPENMETHOD_POLICY_STABLE_VTBLS_HPP
+
+#include <boost/openmethod/preamble.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace boost::openmethod::policies {
+
+//! A v-table was moved by @ref stable_vtbls.
+struct moved_vtbl : openmethod_error {
+    //! The type_id of the class.
+    type_id type;
+
+    //! Write a short description to an output stream
+    //! @param os The output stream
+    //! @tparam Registry The registry
+    //! @tparam Stream A @ref LightweightOutputStream
+    template<class Registry, class Stream>
+    auto write(Stream& os) const -> void {
+        os << "v-table of ";
+        Registry::rtti::type_name(type, os);
+        os << " moved, pointers to it are invalid";
+    }
+};
+
+//! Keep the v-tables at the same addresses across calls to `initialize`.
+//!
+//! `stable_vtbls` implements the @ref vtbl_storage policy. The first time a
+//! class is placed, its v-table is given a block of words, with room for
+//! `Headroom` more slots than it needs. If the next calls to @ref initialize
+//! assign slots that fit in the block, the v-table is rewritten in place, and
+//! @ref registry::static_vptr keeps its value. Thus, the v-table pointers held
+//! by objects and @ref virtual_ptr remain valid after loading a shared
+//! library, without the extra load required by the @ref indirect_vptr policy.
+//!
+//! A v-table that outgrows its block is moved to a new block. Pointers to the
+//! old v-table must then be updated, as with direct pointers in registries
+//! without this policy: the old block is not freed, but its entries for
+//! multi-methods point into dispatch tables that no longer exist. If the
+//! registry contains the @ref runtime_checks policy, each move is reported:
+//! if the registry contains an @ref error_handler policy, its @ref error
+//! function is called with a @ref moved_vtbl object; then the program is
+//! terminated with @ref abort. Choose `Headroom` so that the methods added
+//! by shared libraries fit. The blocks of classes that are no longer
+//! registered, for example after unloading a shared library, are reused.
+//!
+//! On Linux, the blocks are carved from a single range of `ReservedBytes`
+//! bytes of address space, mapped with `mmap` and backed by physical memory
+//! only as it is used. When the range is exhausted, or on other platforms,
+//! blocks are obtained from the free store.
+//!
+//! `stable_vtbls` cannot be used with a @ref replication policy, which copies
+//! the v-tables along with the dispatch tables.
+//!
+//! @tparam ReservedBytes The size of the address space to reserve.
+//! @tparam Headroom The number of slots to add to each block.
+template<
+    std::size_t ReservedBytes = 64 * 1024 * 1024, std::size_t Headroom = 4>
+struct stable_vtbls : vtbl_storage {
+    //! The errors that this policy may report.
+    using errors = std::variant<moved_vtbl>;
+
+    //! A VtblStorageFn metafunction.
+    //!
+    //! @tparam Registry The registry containing this policy.
+    template<class Registry>
+    class fn {
+        static_assert(
+            !Registry::has_replication,
+            "stable_vtbls does not support replication");
+
+        // A block holding the v-table of a class for slots `first_slot` to
+        // `first_slot + capacity - 1`.
+        struct home {
+            detail::word* block;
+            std::size_t first_slot, capacity;
+        };
+
+        static inline detail::word* region = nullptr;
+        static inline std::size_t region_used = 0;
+        static inline bool reserved = false;
+        static inline std::unordered_map<const void*, home> homes;
+        static inline std::vector<std::pair<detail::word*, std::size_t>>
+            free_blocks;
+        static inline std::vector<std::unique_ptr<detail::word[]>> overflow;
+
+        static auto allocate(std::size_t words) -> detail::word*;
+
+      public:
+        //! Places the v-tables of the registered classes.
+        //!
+        //! Keeps a class' v-table in its block if its slots fit, otherwise
+        //! allocates a new block. If the registry contains @ref
+        //! runtime_checks, reports the v-tables that were moved.
+        //!
+        //! @param first A pointer to the first placement.
+        //! @param last A pointer past the last placement.
+        static auto place(vtbl_placement* first, vtbl_placement* last) -> void;
+
+        //! Releases the blocks and the address space.
+        //!
+        //! @tparam Options... Zero or more option types.
+        //! @param options A tuple of option objects.
+        template<class... Options>
+        static auto finalize(const std::tuple<Options...>&) -> void {
+#if defined(__linux__)
+            if (region) {
+                munmap(region, ReservedBytes);
+            }
+#endif
+
+            region = nullptr;
+            region_used = 0;
+            reserved = false;
+            homes.clear();
+            free_blocks.clear();
+            overflow.clear();
+        }
+    };
+};
+
+template<std::size_t ReservedBytes, std::size_t Headroom>
+template<class Registry>
+auto stable_vtbls<ReservedBytes, Headroom>::fn<Registry>::place(
+    vtbl_placement* first, vtbl_placement* last) -> void {
+    decltype(homes) placed;
+
+    for (auto p = first; p != last; ++p) {
+        auto iter = homes.find(p->key);
+        home h;
+
+        if (iter != homes.end() && iter->second.first_slot <= p->first_slot &&
+            p->first_slot + p->size <=
+                iter->second.first_slot + iter->second.capacity) {
+            h = iter->second;
+        } else {
+            // If the v-table outgrew its block, the old block is not reused,
+            // so reading it is not undefined behavior. Only its entries for
+            // single-dispatch methods are still callable; the entries for
+            // multi-methods point into dispatch tables that were freed.
+            if constexpr (Registry::has_runtime_checks) {
+                if (iter != homes.end()) {
+                    if constexpr (Registry::has_error_handler) {
+                        moved_vtbl error;
+                        error.type = p->type;
+                        Registry::error_handler::error(error);
+                    }
+
+                    abort();
+                }
+            }
+
+            h.capacity = p->size + Headroom;
+            h.block = allocate(h.capacity);
+            h.first_slot = p->first_slot;
+        }
+
+        if (iter != homes.end()) {
+            homes.erase(iter);
+        }
+
+        p->vptr = h.block - h.first_slot;
+        placed.emplace(p->key, h);
+    }
+
+    // The remaining classes are no longer registered.
+    for (auto& entry : homes) {
+        free_blocks.emplace_back(entry.second.block, entry.second.capacity);
+    }
+
+    homes.swap(placed);
+}
+
+template<std::size_t ReservedBytes, std::size_t Headroom>
+template<class Registry>
+auto stable_vtbls<ReservedBytes, Headroom>::fn<Registry>::allocate(
+    std::size_t words) -> detail::word* {
+    for (auto iter = free_blocks.begin(); iter != free_blocks.end(); ++iter) {
+        if (iter->second >= words) {
+            auto block = iter->first;
+            iter->first += words;
+            iter->second -= words;
+
+            if (iter->second == 0) {
+                free_blocks.erase(iter);
+            }
+
+            return block;
+        }
+    }
+
+    if (!reserved) {
+        reserved = true;
+
+#if defined(__linux__)
+        auto p = mmap(
+            nullptr, ReservedBytes, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if (p != MAP_FAILED) {
+            region = static_cast<detail::word*>(p);
+        }
+#endif
+    }
+
+    if (region && region_used + words <= ReservedBytes / sizeof(detail::word)) {
+        auto block = region + region_used;
+        region_used += words;
+
+        return block;
+    }
+
+    return overflow.emplace_back(new detail::word[words]).get();
+}
+
+} // namespace boost::openmethod::policies
+
+#endif
@@ -7,13 +7,151 @@
 #define BOOST_OPENMETHOD_POLICY_VPTR_MAP_HPP
 
 #include <boost/openmethod/preamble.hpp>
+#include <boost/openmethod/detail/vtbl_cache.hpp>
 
+#include <cstdint>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace boost::openmethod {
 
+namespace detail {
+
+// An open-addressing hash map keyed by `type_id`s, with linear probing. Its
+// entries are stored in a single array, at most half full, so a lookup
+// usually reads a single cache line. It supports only the operations used by
+// `vptr_map`. The key with all bits set is reserved to mark empty entries.
+template<class Key, class Value>
+class flat_map {
+    static_assert(sizeof(Key) <= sizeof(std::uintptr_t));
+
+  public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    flat_map() : entries(1, value_type(empty_key(), Value())) {
+    }
+
+    auto find(Key key) -> iterator {
+        auto index = hash(key);
+
+        for (;;) {
+            auto& entry = entries[index];
+
+            if (entry.first == key) {
+                return &entry;
+            }
+
+            if (entry.first == empty_key()) {
+                return end();
+            }
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    auto end() -> iterator {
+        return entries.data() + entries.size();
+    }
+
+    auto size() const -> std::size_t {
+        return count;
+    }
+
+    template<typename... Args>
+    auto emplace(Key key, Args&&... args) -> std::pair<iterator, bool> {
+        if (2 * (count + 1) > entries.size()) {
+            grow();
+        }
+
+        auto index = hash(key);
+
+        for (;;) {
+            auto& entry = entries[index];
+
+            if (entry.first == key) {
+                return {&entry, false};
+            }
+
+            if (entry.first == empty_key()) {
+                entry.first = key;
+                entry.second = Value(std::forward<Args>(args)...);
+                ++count;
+
+                return {&entry, true};
+            }
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    auto swap(flat_map& other) noexcept -> void {
+        entries.swap(other.entries);
+        std::swap(count, other.count);
+        std::swap(shift, other.shift);
+        std::swap(mask, other.mask);
+    }
+
+    auto clear() -> void {
+        flat_map().swap(*this);
+    }
+
+  private:
+    std::vector<value_type> entries;
+    std::size_t count = 0;
+    std::size_t shift = 63;
+    std::size_t mask = 0;
+
+    static auto empty_key() -> Key {
+        return Key(~std::uintptr_t(0));
+    }
+
+    auto hash(Key key) const -> std::size_t {
+        return fibonacci_hash(std::uintptr_t(key), shift) & mask;
+    }
+
+    auto grow() -> void {
+        std::size_t bits = 1;
+
+        while ((std::size_t(1) << bits) < 2 * (count + 1)) {
+            ++bits;
+        }
+
+        flat_map bigger;
+        bigger.entries.assign(
+            std::size_t(1) << bits, value_type(empty_key(), Value()));
+        bigger.shift = 64 - bits;
+        bigger.mask = (std::size_t(1) << bits) - 1;
+
+        for (auto& entry : entries) {
+            if (entry.first != empty_key()) {
+                bigger.emplace(entry.first, std::move(entry.second));
+            }
+        }
+
+        swap(bigger);
+    }
+};
+
+} // namespace detail
+
 namespace policies {
 
+//! A quoted metafunction that returns an open-addressing hash map.
+//!
+//! Used as the `MapFn` argument of @ref vptr_map, `flat_map_fn` stores the
+//! v-table pointers in a flat array of key-value pairs, probed linearly from
+//! a position computed from the bits of the `type_id`. Unlike the default
+//! `std::unordered_map`, a lookup does not follow pointers to buckets and
+//! nodes.
+//!
+//! The `type_id` with all bits set is reserved.
+using flat_map_fn = mp11::mp_quote<detail::flat_map>;
+
 //! Stores v-table pointers in a map keyed by `type_id`s.
 //!
 //! `vptr_map` stores v-table pointers in a map keyed by `type_id`s.
@@ -21,8 +159,12 @@ namespace policies {
 //! If the registry contains the @ref indirect_vptr policy, `vptr_map` stores
 //! pointers to pointers to v-tables.
 //!
+//! `vptr_map` cannot be used with a @ref replication policy; use @ref
+//! vptr_vector instead.
+//!
 //! @tparam MapFn A mp11 quoted metafunction that takes a key type and a
-//! value type, and returns an @ref AssociativeContainer.
+//! value type, and returns an @ref AssociativeContainer, for example
+//! @ref flat_map_fn.
 template<class MapFn = mp11::mp_quote<std::unordered_map>>
 class vptr_map : public vptr {
   public:
@@ -31,6 +173,10 @@ class vptr_map : public vptr {
     //! @tparam Registry The registry containing this policy.
     template<class Registry>
     class fn {
+        static_assert(
+            !Registry::has_replication,
+            "vptr_map does not support replication");
+
         using Value = std::conditional_t<
             Registry::has_indirect_vptr, const vptr_type*, vptr_type>;
         static inline typename MapFn::template fn<type_id, Value> vptrs;
@@ -79,7 +225,17 @@ class vptr_map : public vptr {
         //! @return A reference to a the v-table pointer for `Class`.
         template<class Class>
         static auto dynamic_vptr(const Class& arg) -> const vptr_type& {
-            auto type = Registry::rtti::dynamic_type(arg);
+            return type_vptr(Registry::rtti::dynamic_type(arg));
+        }
+
+        //! Returns a *reference* to the v-table pointer for a type.
+        //!
+        //! Same as @ref dynamic_vptr, for a class designated by its @ref
+        //! type_id, as returned by the registry's @ref rtti policy.
+        //!
+        //! @param type The `type_id` of a registered class.
+        //! @return A reference to a the v-table pointer for the class.
+        static auto type_vptr(type_id type) -> const vptr_type& {
             auto iter = vptrs.find(type);
 
             if constexpr (Registry::has_runtime_checks) {
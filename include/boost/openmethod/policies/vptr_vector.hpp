@@ -8,18 +8,72 @@
 
 #include <boost/openmethod/preamble.hpp>
 
-#include <variant>
 #include <vector>
 
 namespace boost::openmethod {
 
 namespace detail {
 
+// A v-table pointer, or a pointer to one, stored next to the type_id it was
+// registered for. Checking the type_id reads the cache line that holds the
+// pointer anyway.
+template<class Vptr>
+struct checked_vptr {
+    type_id type;
+    Vptr vptr;
+};
+
+template<class TypeHash, class = void>
+constexpr bool has_unchecked_hash = false;
+
+template<class TypeHash>
+constexpr bool has_unchecked_hash<
+    TypeHash, std::void_t<decltype(TypeHash::unchecked_hash(type_id()))>> =
+    true;
+
+// An rtti policy that provides `is_ordinal` tells which type_ids can be used
+// as indices, in a registry without a type_hash.
+template<class Rtti, class = void>
+constexpr bool has_is_ordinal = false;
+
+template<class Rtti>
+constexpr bool
+    has_is_ordinal<Rtti, std::void_t<decltype(Rtti::is_ordinal(type_id()))>> =
+        true;
+
+// With runtime checks, and a type_hash that can skip its own check,
+// `vptr_vector` stores `checked_vptr`s and checks the type_id itself.
+template<class Registry>
+constexpr bool vptr_vector_checks_type = Registry::has_runtime_checks &&
+    !Registry::has_replication &&
+    has_unchecked_hash<
+        typename Registry::template policy<policies::type_hash>>;
+
+template<class Registry, class Vptr>
+using vptr_vector_entry = std::conditional_t<
+    vptr_vector_checks_type<Registry>, checked_vptr<Vptr>, Vptr>;
+
+template<class Registry>
+inline std::vector<
+    vptr_vector_entry<Registry, vptr_type>,
+    arena_allocator<vptr_vector_entry<Registry, vptr_type>, Registry>>
+    vptr_vector_vptrs;
+
+template<class Registry>
+inline std::vector<
+    vptr_vector_entry<Registry, const vptr_type*>,
+    arena_allocator<vptr_vector_entry<Registry, const vptr_type*>, Registry>>
+    vptr_vector_indirect_vptrs;
+
+// One index per replica of the dispatch data, if the registry has a
+// replication policy. The first one is `vptr_vector_vptrs`.
 template<class Registry>
-inline std::vector<vptr_type> vptr_vector_vptrs;
+inline std::vector<vptr_type*> vptr_vector_replicas;
 
+// Size of the vector, computed by the measuring pass of the `arena` option,
+// and reused by the pass that builds the vector.
 template<class Registry>
-inline std::vector<const vptr_type*> vptr_vector_indirect_vptrs;
+inline std::size_t vptr_vector_size;
 
 } // namespace detail
 
@@ -33,6 +87,19 @@ namespace policies {
 //!
 //! If the registry contains the @ref indirect_vptr policy, stores pointers to
 //! pointers to v-tables in the vector.
+//!
+//! The vector uses an @ref arena_allocator, so it is placed in front of the
+//! v-tables if the registry is initialized with the @ref arena option.
+//!
+//! If the registry contains a @ref replication policy, a copy of the vector is
+//! made for each replica of the dispatch data, and `dynamic_vptr` uses the copy
+//! for the calling thread's replica.
+//!
+//! If the registry contains the @ref runtime_checks policy, and its @ref
+//! type_hash provides an `unchecked_hash` function, each entry of the vector
+//! holds the `type_id` next to the v-table pointer. `dynamic_vptr` checks the
+//! `type_id` against the entry it reads, instead of the hash function checking
+//! it against a separate table.
 struct vptr_vector : vptr {
   public:
     //! A VptrFn metafunction.
@@ -51,11 +118,21 @@ struct vptr_vector : vptr {
         using type_hash =
             typename Registry::template policy<policies::type_hash>;
         static constexpr auto has_type_hash = !std::is_same_v<type_hash, void>;
+        static constexpr auto checks_type =
+            detail::vptr_vector_checks_type<Registry>;
+
+        static_assert(
+            !(Registry::has_replication && Registry::has_indirect_vptr),
+            "vptr_vector does not support replication with indirect_vptr");
 
         //! Stores the v-table pointers.
         //!
         //! If `Registry` contains a @ref type_hash policy, its `initialize`
         //! function is called. Its result determines the size of the vector.
+        //! Otherwise, if the @ref rtti policy provides an `is_ordinal`
+        //! function, and it returns `false` for the `type_id` of a class,
+        //! calls the registry's @ref error_handler, if it has one, with a @ref
+        //! missing_class value, then terminates the program with @ref abort.
         //! The v-table pointers are copied into the vector.
         //!
         //! @tparam Context An @ref InitializeContext.
@@ -65,10 +142,14 @@ struct vptr_vector : vptr {
         template<class Context, class... Options>
         static auto initialize(
             const Context& ctx, const std::tuple<Options...>& options) -> void {
+            using arena = detail::arena_state<Registry>;
             std::size_t size;
             (void)options;
 
-            if constexpr (has_type_hash) {
+            if (arena::measured) {
+                // The type_hash was initialized by the measuring pass.
+                size = detail::vptr_vector_size<Registry>;
+            } else if constexpr (has_type_hash) {
                 auto [_, max_value] = type_hash::initialize(ctx, options);
                 size = max_value + 1;
             } else {
@@ -78,6 +159,20 @@ struct vptr_vector : vptr {
                      ++iter) {
                     for (auto type_iter = iter->type_id_begin();
                          type_iter != iter->type_id_end(); ++type_iter) {
+                        if constexpr (detail::has_is_ordinal<
+                                          typename Registry::rtti>) {
+                            if (!Registry::rtti::is_ordinal(*type_iter)) {
+                                missing_class error;
+                                error.type = *type_iter;
+
+                                if constexpr (Registry::has_error_handler) {
+                                    Registry::error_handler::error(error);
+                                }
+
+                                abort();
+                            }
+                        }
+
                         size = (std::max)(size, std::size_t(*type_iter));
                     }
                 }
@@ -85,10 +180,30 @@ struct vptr_vector : vptr {
                 ++size;
             }
 
+            if (arena::measuring) {
+                using entry = typename std::conditional_t<
+                    Registry::has_indirect_vptr,
+                    decltype(detail::vptr_vector_indirect_vptrs<Registry>),
+                    decltype(detail::vptr_vector_vptrs<Registry>)>::value_type;
+                detail::vptr_vector_size<Registry> = size;
+                arena::requested += size * sizeof(entry);
+
+                return;
+            }
+
+            if constexpr (Registry::has_replication) {
+                release_replicas();
+            }
+
+            // Always allocate a new vector, so it is placed in the arena if
+            // there is one.
             if constexpr (Registry::has_indirect_vptr) {
-                detail::vptr_vector_indirect_vptrs<Registry>.resize(size);
+                detail::vptr_vector_indirect_vptrs<Registry> =
+                    decltype(detail::vptr_vector_indirect_vptrs<Registry>)(
+                        size);
             } else {
-                detail::vptr_vector_vptrs<Registry>.resize(size);
+                detail::vptr_vector_vptrs<Registry> =
+                    decltype(detail::vptr_vector_vptrs<Registry>)(size);
             }
 
             for (auto iter = ctx.classes_begin(); iter != ctx.classes_end();
@@ -104,14 +219,20 @@ struct vptr_vector : vptr {
                     }
 
                     if constexpr (Registry::has_indirect_vptr) {
-                        detail::vptr_vector_indirect_vptrs<Registry>[index] =
-                            &iter->vptr();
+                        store(
+                            detail::vptr_vector_indirect_vptrs<Registry>[index],
+                            *type_iter, &iter->vptr());
                     } else {
-                        detail::vptr_vector_vptrs<Registry>[index] =
-                            iter->vptr();
+                        store(
+                            detail::vptr_vector_vptrs<Registry>[index],
+                            *type_iter, iter->vptr());
                     }
                 }
             }
+
+            if constexpr (Registry::has_replication) {
+                replicate();
+            }
         }
 
         //! Returns a *reference* to a v-table pointer for an object.
@@ -123,19 +244,34 @@ struct vptr_vector : vptr {
         //! type id to an index; otherwise, uses the type_id as the index.
         //!
         //! If the registry contains the @ref runtime_checks policy, verifies
-        //! that the index falls within the limits of the vector. If it does
-        //! not, and if the registry contains a @ref error_handler policy, calls
-        //! its @ref error function with a @ref missing_class value, then
-        //! terminates the program with @ref abort.
+        //! that the index falls within the limits of the vector. If the vector
+        //! stores `type_id`s, also verifies that the entry was registered for
+        //! the dynamic type. If either check fails, and if the registry
+        //! contains a @ref error_handler policy, calls its @ref error function
+        //! with a @ref missing_class value, then terminates the program with
+        //! @ref abort.
         //!
         //! @tparam Class A registered class.
         //! @param arg A reference to a const object of type `Class`.
         //! @return A reference to a the v-table pointer for `Class`.
         template<class Class>
         static auto dynamic_vptr(const Class& arg) -> const vptr_type& {
-            auto dynamic_type = Registry::rtti::dynamic_type(arg);
+            return type_vptr(Registry::rtti::dynamic_type(arg));
+        }
+
+        //! Returns a *reference* to the v-table pointer for a type.
+        //!
+        //! Same as @ref dynamic_vptr, for a class designated by its @ref
+        //! type_id, as returned by the registry's @ref rtti policy.
+        //!
+        //! @param dynamic_type The `type_id` of a registered class.
+        //! @return A reference to a the v-table pointer for the class.
+        static auto type_vptr(type_id dynamic_type) -> const vptr_type& {
             std::size_t index;
-            if constexpr (has_type_hash) {
+
+            if constexpr (checks_type) {
+                index = type_hash::unchecked_hash(dynamic_type);
+            } else if constexpr (has_type_hash) {
                 index = type_hash::hash(dynamic_type);
             } else {
                 index = std::size_t(dynamic_type);
@@ -151,19 +287,26 @@ struct vptr_vector : vptr {
                     }
 
                     if (index >= max_index) {
-                        if constexpr (Registry::has_error_handler) {
-                            missing_class error;
-                            error.type = dynamic_type;
-                            Registry::error_handler::error(error);
-                        }
-
-                        abort();
+                        missing(dynamic_type);
                     }
                 }
             }
 
-            if constexpr (Registry::has_indirect_vptr) {
+            if constexpr (checks_type) {
+                if constexpr (Registry::has_indirect_vptr) {
+                    return *checked_entry(
+                        detail::vptr_vector_indirect_vptrs<Registry>, index,
+                        dynamic_type);
+                } else {
+                    return checked_entry(
+                        detail::vptr_vector_vptrs<Registry>, index,
+                        dynamic_type);
+                }
+            } else if constexpr (Registry::has_indirect_vptr) {
                 return *detail::vptr_vector_indirect_vptrs<Registry>[index];
+            } else if constexpr (Registry::has_replication) {
+                return detail::vptr_vector_replicas<
+                    Registry>[Registry::replication::local_replica()][index];
             } else {
                 return detail::vptr_vector_vptrs<Registry>[index];
             }
@@ -178,12 +321,90 @@ struct vptr_vector : vptr {
         static auto finalize(const std::tuple<Options...>&) -> void {
             using namespace policies;
 
+            if constexpr (Registry::has_replication) {
+                release_replicas();
+            }
+
             if constexpr (Registry::has_indirect_vptr) {
                 detail::vptr_vector_indirect_vptrs<Registry>.clear();
             } else {
                 detail::vptr_vector_vptrs<Registry>.clear();
             }
         }
+
+      private:
+        template<class Entry, class Vptr>
+        static auto store(Entry& entry, type_id type, Vptr vptr) -> void {
+            if constexpr (checks_type) {
+                entry.type = type;
+                entry.vptr = vptr;
+            } else {
+                (void)type;
+                entry = vptr;
+            }
+        }
+
+        template<class Vector>
+        BOOST_FORCEINLINE static auto
+        checked_entry(const Vector& vptrs, std::size_t index, type_id type)
+            -> const decltype(vptrs[0].vptr)& {
+            if (index >= vptrs.size() || vptrs[index].type != type) {
+                missing(type);
+            }
+
+            return vptrs[index].vptr;
+        }
+
+        [[noreturn]] static auto missing(type_id type) -> void {
+            if constexpr (Registry::has_error_handler) {
+                missing_class error;
+                error.type = type;
+                Registry::error_handler::error(error);
+            }
+
+            abort();
+        }
+
+        // Make a copy of the index for each replica of the dispatch data,
+        // pointing to the v-tables in that replica.
+        static auto replicate() -> void {
+            auto& vptrs = detail::vptr_vector_vptrs<Registry>;
+            auto& replicas = detail::vptr_vector_replicas<Registry>;
+            auto& offsets = detail::replication_state<Registry>::offsets;
+
+            replicas.push_back(vptrs.data());
+
+            for (std::size_t replica = 1; replica < offsets.size();
+                 ++replica) {
+                auto copy = static_cast<vptr_type*>(
+                    Registry::replication::allocate(
+                        replica, vptrs.size() * sizeof(vptr_type)));
+
+                for (std::size_t i = 0; i < vptrs.size(); ++i) {
+                    copy[i] = vptrs[i]
+                        ? reinterpret_cast<vptr_type>(
+                              reinterpret_cast<const char*>(vptrs[i]) +
+                              offsets[replica])
+                        : nullptr;
+                }
+
+                replicas.push_back(copy);
+            }
+        }
+
+        static auto release_replicas() -> void {
+            auto& replicas = detail::vptr_vector_replicas<Registry>;
+            auto bytes =
+                detail::vptr_vector_vptrs<Registry>.size() * sizeof(vptr_type);
+
+            for (std::size_t replica = 1; replica < replicas.size();
+                 ++replica) {
+                Registry::replication::deallocate(
+                    replica, replicas[replica], bytes);
+            }
+
+            replicas.clear();
+        }
     };
 };
 
@@ -7,9 +7,12 @@
 #include <boost/mp11/bind.hpp>
 
 #include <stdlib.h>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <cstdint>
 #include <string_view>
+#include <utility>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -70,6 +73,9 @@ struct virtual_;
 template<typename T, class Registry>
 struct virtual_traits;
 
+template<class Class, class Registry>
+class compact_inplace_vptr_base;
+
 // -----------------------------------------------------------------------------
 // Error handling
 
@@ -282,6 +288,48 @@ struct final_error : openmethod_error {
     auto write(Stream& os) const;
 };
 
+//! V-table pointer does not fit in a compact encoding.
+//!
+//! @ref compact_inplace_vptr_base and @ref compact_virtual_ptr store a v-table
+//! pointer, or an index that designates it, in fewer bits than a pointer. If
+//! runtime checks are enabled, and the value does not fit, and if the registry
+//! contains an @ref error_handler policy, its @ref error function is called
+//! with a `compact_vptr_overflow` object, then the program is terminated with
+//! @ref abort.
+struct compact_vptr_overflow : openmethod_error {
+    //! The type_id of the class.
+    type_id type;
+
+    //! Write a short description to an output stream
+    //! @param os The output stream
+    //! @tparam Registry The registry
+    //! @tparam Stream A @ref LightweightOutputStream
+    template<class Registry, class Stream>
+    auto write(Stream& os) const;
+};
+
+//! Object address does not fit in a compact encoding.
+//!
+//! @ref compact_virtual_ptr stores the address of an object in the low 48 bits
+//! of a word. If runtime checks are enabled, and the address does not fit, and
+//! if the registry contains an @ref error_handler policy, its @ref error
+//! function is called with a `compact_address_overflow` object, then the
+//! program is terminated with @ref abort.
+struct compact_address_overflow : openmethod_error {
+    //! The type_id of the class.
+    type_id type;
+
+    //! The address of the object.
+    const void* address;
+
+    //! Write a short description to an output stream
+    //! @param os The output stream
+    //! @tparam Registry The registry
+    //! @tparam Stream A @ref LightweightOutputStream
+    template<class Registry, class Stream>
+    auto write(Stream& os) const;
+};
+
 namespace detail {
 
 struct empty {};
@@ -308,6 +356,8 @@ struct range {
 struct class_info : static_list<class_info>::static_link {
     type_id type;
     vptr_type* static_vptr;
+    bool* is_leaf;
+    std::uint32_t compact_index;
     type_id *first_base, *last_base;
     bool is_abstract{false};
 
@@ -328,6 +378,40 @@ struct deferred_class_info : class_info {
     virtual void resolve_type_ids() = 0;
 };
 
+// Each class gets a 32-bit index in `compact_vptrs` when it is registered.
+// `compact_inplace_vptr_base` (in registries with `indirect_vptr`) and
+// `compact_virtual_ptr` store it instead of a v-table pointer. The index does
+// not change when the registry is initialized again; the table is rebuilt
+// instead. Index 0 is not used, and its entry is null.
+template<class Registry>
+inline std::uint32_t compact_vptr_count;
+
+template<class Registry, class Class>
+inline std::uint32_t compact_vptr_index;
+
+// The v-table pointers, by index. With `indirect_vptr`, pointers to the
+// `static_vptr` of the classes, which stay at the same address when the table
+// is rebuilt.
+template<class Registry>
+inline std::vector<std::conditional_t<
+    Registry::has_indirect_vptr, const vptr_type*, vptr_type>>
+    compact_vptrs;
+
+// The indexes sorted by type_id, to find the index of an object's class from
+// its dynamic type. The v-table pointer would not do: classes that share a
+// v-table have different indexes.
+template<class Registry>
+inline std::vector<std::pair<type_id, std::uint32_t>> compact_type_indexes;
+
+// Set when a `compact_virtual_ptr` or an indirect `compact_inplace_vptr_base`
+// is used with the registry. Otherwise, `initialize` does not build the
+// tables.
+template<class Registry>
+inline bool compact_vptrs_used = false;
+
+template<class Registry>
+inline const bool use_compact_vptrs = (compact_vptrs_used<Registry> = true);
+
 // -----------
 // method info
 
@@ -412,6 +496,213 @@ struct LightweightOutputStream {
 //!   the same program.
 struct n2216 {};
 
+//! Remove abstract classes from dispatch tables.
+//!
+//! If `concrete_only` is present in @ref initialize\'s `Options`, the groups
+//! of classes that contain only abstract classes are removed from the
+//! dimensions of the multi-method dispatch tables. Since the dynamic type of an
+//! object cannot be an abstract class, the corresponding cells are never used,
+//! except during the construction and destruction of objects.
+//!
+//! The v-table entries of the abstract classes are redirected to the first
+//! remaining group. Calling a method from a constructor or a destructor, with a
+//! virtual argument that refers to the object being constructed or destroyed,
+//! is undefined behavior. If the registry contains the @ref runtime_checks
+//! policy, the abstract classes are gathered in a single group instead, which
+//! dispatches to the "not implemented" handler, and is not included in the
+//! `not_implemented` report counter.
+//!
+//! The number of cells removed is reported in the `dropped_cells` member of
+//! the report returned by @ref initialize.
+struct concrete_only {};
+
+//! Place the registry's runtime data in a single arena.
+//!
+//! If `arena` is present in @ref initialize's `Options`, the index used by the
+//! @ref vptr policy to find the v-table pointers (if it uses @ref
+//! arena_allocator), the v-tables, and the multi-method dispatch tables are
+//! placed, in that order, in a single block of memory. Each part starts on a
+//! cache line boundary.
+//!
+//! The block is smaller and denser than the separate allocations, which
+//! reduces cache and TLB misses. In exchange, the @ref vptr policy is
+//! initialized twice, with the same options: once to measure the size of its
+//! index, and once to build it in the arena. @ref vptr_vector computes its
+//! size, including the @ref type_hash search, only in the first pass, and
+//! allocates nothing in it.
+struct arena {};
+
+namespace detail {
+
+// Allocates via the registry's memory policy if it has one, or from the free
+// store.
+template<typename T, class Registry>
+struct memory_allocator {
+    using value_type = T;
+
+    memory_allocator() = default;
+
+    template<typename U>
+    memory_allocator(const memory_allocator<U, Registry>&) {
+    }
+
+    auto allocate(std::size_t n) -> T* {
+        if constexpr (Registry::has_memory) {
+            return static_cast<T*>(Registry::memory::allocate(n * sizeof(T)));
+        } else {
+            return std::allocator<T>().allocate(n);
+        }
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if constexpr (Registry::has_memory) {
+            Registry::memory::deallocate(p, n * sizeof(T));
+        } else {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    template<typename U>
+    auto operator==(const memory_allocator<U, Registry>&) const -> bool {
+        return true;
+    }
+
+    template<typename U>
+    auto operator!=(const memory_allocator<U, Registry>&) const -> bool {
+        return false;
+    }
+};
+
+// Copies of the dispatch data made for the replication policy. Replica 0 is the
+// dispatch data itself.
+template<class Registry>
+struct replication_state {
+    // Offset in bytes from the dispatch data to each replica.
+    static inline std::vector<std::ptrdiff_t> offsets;
+    // Start and size in bytes of each copy, starting with replica 1.
+    static inline std::vector<std::pair<void*, std::size_t>> copies;
+
+    static void release() {
+        std::size_t replica = 1;
+
+        for (auto [p, bytes] : copies) {
+            Registry::replication::deallocate(replica++, p, bytes);
+        }
+
+        copies.clear();
+        offsets.clear();
+    }
+};
+
+// Memory reserved in the dispatch data for the next allocation made via an
+// arena_allocator, when initializing with the `arena` option.
+template<class Registry>
+struct arena_state {
+    // If true, record the size of allocations instead of serving them.
+    static inline bool measuring = false;
+    // Number of bytes requested while measuring.
+    static inline std::size_t requested = 0;
+    // If true, the vptr policy is being initialized right after a measuring
+    // pass, with the same context and options, and may reuse its results.
+    static inline bool measured = false;
+    // Start and size of the reserved memory.
+    static inline void* first = nullptr;
+    static inline std::size_t size = 0;
+
+    // Address range of the memory reserved in a dispatch data block.
+    struct block {
+        const void* first;
+        const void* last;
+
+        auto contains(const void* p) const -> bool {
+            auto less = std::less<const void*>();
+            return !less(p, first) && less(p, last);
+        }
+    };
+
+    // The reserved memory in the current dispatch data, and in the dispatch
+    // data being built. Memory in these blocks is released along with the
+    // dispatch data. They are trivially destructible, thus they remain usable
+    // while static vectors allocated in the arena are destroyed at exit, in
+    // any order relative to the dispatch data.
+    static inline block current = {nullptr, nullptr};
+    static inline block next = {nullptr, nullptr};
+
+    // Restores the default state when leaving a pass, even if the vptr
+    // policy throws.
+    struct pass {
+        pass() = default;
+        pass(const pass&) = delete;
+
+        ~pass() {
+            measuring = false;
+            measured = false;
+            first = nullptr;
+            size = 0;
+            next = {nullptr, nullptr};
+        }
+    };
+};
+
+} // namespace detail
+
+//! Allocator for the data structures of the @ref vptr policies.
+//!
+//! `arena_allocator` allocates memory via the registry's @ref memory policy,
+//! or from the free store, unless the registry is being initialized with the
+//! @ref arena option. In that case, the memory is allocated in the registry's
+//! dispatch data.
+//!
+//! @tparam T The type of the objects to allocate.
+//! @tparam Registry The registry.
+template<typename T, class Registry>
+struct arena_allocator {
+    using value_type = T;
+
+    arena_allocator() = default;
+
+    template<typename U>
+    arena_allocator(const arena_allocator<U, Registry>&) {
+    }
+
+    auto allocate(std::size_t n) -> T* {
+        using arena = detail::arena_state<Registry>;
+        auto bytes = n * sizeof(T);
+
+        if (arena::measuring) {
+            arena::requested += bytes;
+        } else if (arena::first && bytes <= arena::size) {
+            auto p = static_cast<T*>(arena::first);
+            arena::first = nullptr;
+            arena::size = 0;
+
+            return p;
+        }
+
+        return detail::memory_allocator<T, Registry>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        using arena = detail::arena_state<Registry>;
+
+        if (arena::current.contains(p) || arena::next.contains(p)) {
+            return;
+        }
+
+        detail::memory_allocator<T, Registry>().deallocate(p, n);
+    }
+
+    template<typename U>
+    auto operator==(const arena_allocator<U, Registry>&) const -> bool {
+        return true;
+    }
+
+    template<typename U>
+    auto operator!=(const arena_allocator<U, Registry>&) const -> bool {
+        return false;
+    }
+};
+
 //! Enable `initialize` tracing.
 //!
 //! If `trace` is passed to @ref initialize, tracing code is added to various
@@ -664,6 +955,15 @@ struct VptrFn {
     template<class Class>
     static auto dynamic_vptr(const Class& arg) -> const vptr_type&;
 
+    //! Return a *reference* to the v-table pointer for a type.
+    //!
+    //! This function is optional. It is required by @ref
+    //! method::resolve_types.
+    //!
+    //! @param type The `type_id` of a registered class.
+    //! @return A reference to a the v-table pointer for the class.
+    static auto type_vptr(type_id type) -> const vptr_type&;
+
     //! Release the resources allocated by `initialize`.
     //!
     //! This function is optional.
@@ -725,6 +1025,16 @@ struct TypeHashFn {
     //! @return A hash value for the given `type_id`.
     static auto hash(type_id type) -> std::size_t;
 
+    //! Hash a `type_id`, without checking it.
+    //!
+    //! This function is optional. If it is present, and the registry contains
+    //! the @ref runtime_checks policy, @ref vptr_vector calls it instead of
+    //! `hash`, and checks the `type_id` itself.
+    //!
+    //! @param type A @ref type_id.
+    //! @return A hash value for the given `type_id`.
+    static auto unchecked_hash(type_id type) -> std::size_t;
+
     //! Release the resources allocated by `initialize`.
     //!
     //! This function is optional.
@@ -793,6 +1103,268 @@ struct runtime_checks final {
     struct fn {};
 };
 
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref sparse_dispatch metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct SparseDispatchFn {
+    //! Number of cells above which a dispatch table is compressed.
+    static constexpr std::size_t threshold;
+};
+
+#endif
+
+//! Policy for compressing large multi-method dispatch tables.
+//!
+//! The dispatch table of a multi-method has one cell for each combination of
+//! argument groups, and thus grows multiplicatively with the number of virtual
+//! parameters. If this policy is present, the dispatch table of a multi-method
+//! with more than `threshold` cells is replaced with a decision tree, indexed
+//! by one virtual argument at each level, in which identical sub-trees are
+//! shared. This costs one extra memory read per virtual argument, except for
+//! the first and the last.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `sparse_dispatch`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! SparseDispatchFn blueprint.
+struct sparse_dispatch {
+    // Policy category.
+    using category = sparse_dispatch;
+};
+
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref compact_tables metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct CompactTablesFn {
+    //! An unsigned integer type, used for the cells of the dispatch tables.
+    using cell_type = detail::unspecified;
+
+    //! Checks that the overriders of a method can be indexed by `cell_type`.
+    //!
+    //! @param method The @ref type_id of the method.
+    //! @param functions The number of function pointers to index, including
+    //! the "not implemented" and "ambiguous" handlers.
+    static auto check(type_id method, std::size_t functions) -> void;
+};
+
+#endif
+
+//! Policy for the representation of multi-method dispatch tables.
+//!
+//! If this policy is present, the cells of the multi-method dispatch tables
+//! contain indexes into a per-method array of function pointers, instead of the
+//! function pointers themselves. The indexes have a type smaller than a
+//! pointer, making the tables smaller, at the cost of one extra memory read per
+//! call.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `compact_tables`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! CompactTablesFn blueprint.
+struct compact_tables {
+    // Policy category.
+    using category = compact_tables;
+};
+
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref memory metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct MemoryFn {
+    //! Allocates memory.
+    //!
+    //! @param bytes The number of bytes to allocate.
+    //! @return A pointer to a block of at least `bytes` bytes, aligned on a
+    //! 64 byte boundary.
+    static auto allocate(std::size_t bytes) -> void*;
+
+    //! Releases memory allocated by `allocate`.
+    //!
+    //! @param p A pointer returned by `allocate`.
+    //! @param bytes The number of bytes passed to `allocate`.
+    static auto deallocate(void* p, std::size_t bytes) -> void;
+};
+
+#endif
+
+//! Policy for the memory backing the dispatch data.
+//!
+//! If this policy is present, it is used to allocate the registry's v-tables
+//! and dispatch tables, and the indexes of the @ref vptr policies that use
+//! @ref arena_allocator. Otherwise, the memory is obtained from the free store.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `memory`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! MemoryFn blueprint.
+struct memory {
+    // Policy category.
+    using category = memory;
+};
+
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref replication metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct ReplicationFn {
+    //! Returns the number of replicas to create.
+    //!
+    //! Called by @ref registry::initialize. Replica 0 is the registry's
+    //! dispatch data itself; the other replicas are copies.
+    //!
+    //! @return The number of replicas, at least 1.
+    static auto initialize() -> std::size_t;
+
+    //! Allocates memory for a replica.
+    //!
+    //! @param replica The index of the replica, greater than 0.
+    //! @param bytes The number of bytes to allocate.
+    //! @return A pointer to a block of at least `bytes` bytes, aligned on a
+    //! 64 byte boundary.
+    static auto allocate(std::size_t replica, std::size_t bytes) -> void*;
+
+    //! Releases memory allocated by `allocate`.
+    //!
+    //! @param replica The index of the replica.
+    //! @param p A pointer returned by `allocate`.
+    //! @param bytes The number of bytes passed to `allocate`.
+    static auto deallocate(std::size_t replica, void* p, std::size_t bytes)
+        -> void;
+
+    //! Returns the replica to use on the calling thread.
+    //!
+    //! @return A replica index, less than the value returned by `initialize`.
+    static auto local_replica() -> std::size_t;
+};
+
+#endif
+
+//! Policy for replicating the dispatch data.
+//!
+//! If this policy is present, @ref registry::initialize makes copies of the
+//! v-tables and dispatch tables, and the @ref vptr_vector policy makes
+//! matching copies of its index. Each thread dispatches through the replica
+//! designated by `local_replica`, typically the one on its NUMA node.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `replication`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! ReplicationFn blueprint.
+struct replication {
+    // Policy category.
+    using category = replication;
+};
+
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref downcast metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct DowncastFn {
+    //! Casts an object from a virtual base to a derived class.
+    //!
+    //! @tparam D A reference to a subclass of `B`.
+    //! @tparam B A registered class, a virtual base of `D`.
+    //! @param obj A reference to an instance of `B`.
+    template<typename D, typename B>
+    static auto dynamic_cast_ref(B&& obj) -> D;
+};
+
+#endif
+
+//! Policy for casting virtual arguments from virtual bases.
+//!
+//! Passing a virtual argument to an overrider whose parameter is a class that
+//! derives virtually from the method's parameter cannot be done with
+//! `static_cast`. By default, the cast is performed by the @ref rtti policy's
+//! `dynamic_cast_ref`, or by `dynamic_cast` or `std::dynamic_pointer_cast`. If
+//! this policy is present, it is used instead.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `downcast`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! DowncastFn blueprint.
+struct downcast {
+    // Policy category.
+    using category = downcast;
+};
+
+//! The v-table of a class, as placed by a @ref vtbl_storage policy.
+struct vtbl_placement {
+    //! Identifies the class across calls to @ref initialize.
+    const void* key;
+
+    //! The @ref type_id of the class.
+    type_id type;
+
+    //! The first slot used by the v-table.
+    std::size_t first_slot;
+
+    //! The number of slots used by the v-table.
+    std::size_t size;
+
+    //! Set by the policy to the address of slot 0 of the v-table.
+    detail::word* vptr;
+};
+
+#ifdef __MRDOCS__
+
+//! Blueprint for @ref vtbl_storage metafunctions (exposition only).
+//!
+//! @tparam Registry The registry containing the policy.
+template<class Registry>
+struct VtblStorageFn {
+    //! Places the v-tables of the registered classes.
+    //!
+    //! Called by @ref registry::initialize. For each placement, sets `vptr` to
+    //! a pointer `p` such that `p[first_slot]` to `p[first_slot + size - 1]`
+    //! can be written.
+    //!
+    //! @param first A pointer to the first placement.
+    //! @param last A pointer past the last placement.
+    static auto place(vtbl_placement* first, vtbl_placement* last) -> void;
+};
+
+#endif
+
+//! Policy for the storage of the v-tables.
+//!
+//! If this policy is present, the v-tables are not part of the dispatch data.
+//! Instead, @ref registry::initialize asks the policy where to write them,
+//! without sharing storage between v-tables with the same contents.
+//!
+//! @par Requirements
+//!
+//! Classes implementing this policy must:
+//! @li derive from `vtbl_storage`.
+//! @li provide a `fn<Registry>` metafunction that conforms to the @ref
+//! VtblStorageFn blueprint.
+struct vtbl_storage {
+    // Policy category.
+    using category = vtbl_storage;
+};
+
 } // namespace policies
 
 namespace detail {
@@ -927,8 +1499,14 @@ class registry : detail::registry_base {
     friend struct detail::use_class_aux;
     template<typename Name, typename ReturnType, class Registry>
     friend class method;
-
-    static std::vector<detail::word> dispatch_data;
+    template<typename, class>
+    friend struct arena_allocator;
+    template<class, class>
+    friend class compact_inplace_vptr_base;
+
+    static std::vector<
+        detail::word, detail::memory_allocator<detail::word, registry>>
+        dispatch_data;
     static bool initialized;
 
   public:
@@ -961,6 +1539,18 @@ class registry : detail::registry_base {
     template<class Class>
     static vptr_type static_vptr;
 
+    //! `true` if a registered class has no registered derived classes.
+    //!
+    //! `is_leaf` is set by @ref registry::initialize. If the registry contains
+    //! the @ref runtime_checks policy, and no @ref replication policy, method
+    //! calls with an argument whose static type is a leaf class compare its
+    //! dynamic type with the static type, and, if they are the same, use @ref
+    //! static_vptr instead of the @ref vptr policy.
+    //!
+    //! @tparam Class A registered class.
+    template<class Class>
+    static bool is_leaf;
+
     //! List of policies selected in a registry.
     //!
     //! `policy_list` is a Boost.Mp11 list containing the policies passed to the
@@ -1038,6 +1628,45 @@ class registry : detail::registry_base {
     //! `true` if the registry has an indirect_vptr policy.
     static constexpr auto has_indirect_vptr =
         !std::is_same_v<policy<policies::indirect_vptr>, void>;
+
+    //! The registry's sparse_dispatch policy if it contains one, or `void`.
+    using sparse_dispatch = policy<policies::sparse_dispatch>;
+
+    //! `true` if the registry has a sparse_dispatch policy.
+    static constexpr auto has_sparse_dispatch =
+        !std::is_same_v<sparse_dispatch, void>;
+
+    //! The registry's compact_tables policy if it contains one, or `void`.
+    using compact_tables = policy<policies::compact_tables>;
+
+    //! `true` if the registry has a compact_tables policy.
+    static constexpr auto has_compact_tables =
+        !std::is_same_v<compact_tables, void>;
+
+    //! The registry's memory policy if it contains one, or `void`.
+    using memory = policy<policies::memory>;
+
+    //! `true` if the registry has a memory policy.
+    static constexpr auto has_memory = !std::is_same_v<memory, void>;
+
+    //! The registry's replication policy if it contains one, or `void`.
+    using replication = policy<policies::replication>;
+
+    //! `true` if the registry has a replication policy.
+    static constexpr auto has_replication = !std::is_same_v<replication, void>;
+
+    //! The registry's downcast policy if it contains one, or `void`.
+    using downcast = policy<policies::downcast>;
+
+    //! `true` if the registry has a downcast policy.
+    static constexpr auto has_downcast = !std::is_same_v<downcast, void>;
+
+    //! The registry's vtbl_storage policy if it contains one, or `void`.
+    using vtbl_storage = policy<policies::vtbl_storage>;
+
+    //! `true` if the registry has a vtbl_storage policy.
+    static constexpr auto has_vtbl_storage =
+        !std::is_same_v<vtbl_storage, void>;
 };
 
 template<class... Policies>
@@ -1047,7 +1676,9 @@ template<class... Policies>
 detail::method_catalog registry<Policies...>::methods;
 
 template<class... Policies>
-std::vector<detail::word> registry<Policies...>::dispatch_data;
+std::vector<
+    detail::word, detail::memory_allocator<detail::word, registry<Policies...>>>
+    registry<Policies...>::dispatch_data;
 
 template<class... Policies>
 bool registry<Policies...>::initialized;
@@ -1056,6 +1687,10 @@ template<class... Policies>
 template<class Class>
 vptr_type registry<Policies...>::static_vptr;
 
+template<class... Policies>
+template<class Class>
+bool registry<Policies...>::is_leaf;
+
 template<class... Policies>
 void registry<Policies...>::require_initialized() {
     if constexpr (registry::has_runtime_checks) {
@@ -1091,6 +1726,18 @@ auto final_error::write(Stream& os) const {
     Registry::rtti::type_name(dynamic_type, os);
 }
 
+template<class Registry, class Stream>
+auto compact_vptr_overflow::write(Stream& os) const {
+    os << "v-table pointer does not fit in compact encoding: ";
+    Registry::rtti::type_name(type, os);
+}
+
+template<class Registry, class Stream>
+auto compact_address_overflow::write(Stream& os) const {
+    os << "object address does not fit in compact encoding: ";
+    Registry::rtti::type_name(type, os);
+}
+
 } // namespace boost::openmethod
 
 #ifdef _MSC_VER
@@ -0,0 +1,173 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_ROUTING_TABLE_HPP
+#define BOOST_OPENMETHOD_ROUTING_TABLE_HPP
+
+#include <boost/openmethod/core.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+namespace boost::openmethod {
+
+//! Precomputed overriders for combinations of classes.
+//!
+//! A `routing_table` holds, for each combination of classes taken from one
+//! list of `type_id`s per virtual parameter, the overrider that a call with
+//! arguments of these classes would select. The overriders are resolved once,
+//! when the table is built, as if by @ref method::resolve_types. Looking up an
+//! overrider costs an index computation and a load.
+//!
+//! The classes are designated by their position in their list. Typically, the
+//! lists are indexed by a tag that identifies a class before an object is
+//! created, for example a message type read by a deserializer.
+//!
+//! The table is valid until the next call to `initialize` or `finalize`. It
+//! must then be built again.
+//!
+//! @par Example
+//!
+//! @code
+//! using handle = BOOST_OPENMETHOD_TYPE(
+//!     handle, (virtual_ptr<Message>, virtual_ptr<Handler>), void);
+//!
+//! using rtti = default_registry::rtti;
+//!
+//! routing_table<handle> routes(
+//!     std::vector<type_id>{
+//!         rtti::static_type<Login>(), rtti::static_type<Logout>()},
+//!     std::vector<type_id>{
+//!         rtti::static_type<Audit>(), rtti::static_type<Forward>()});
+//!
+//! auto pf = routes(message_tag, handler_tag);
+//! @endcode
+//!
+//! @par Requirements
+//!
+//! The registry's @ref vptr policy must provide a `type_vptr` function.
+//!
+//! @tparam Method A @ref method.
+template<class Method>
+class routing_table {
+    using function_pointer = typename Method::FunctionPointer;
+    static constexpr std::size_t arity = Method::Arity;
+
+    std::vector<function_pointer> overriders;
+    std::size_t sizes[arity] = {};
+
+    template<class... Indexes>
+    auto offset(Indexes... indexes) const -> std::size_t;
+
+  public:
+    //! Construct an empty table.
+    routing_table() = default;
+
+    //! Build a table.
+    //!
+    //! @tparam TypeIdRanges Ranges of objects convertible to `type_id`, one
+    //! for each virtual parameter of the method.
+    //! @param types For each virtual parameter, the `type_id`s of registered
+    //! classes.
+    template<class... TypeIdRanges>
+    explicit routing_table(const TypeIdRanges&... types);
+
+    //! Return the overrider for a combination of classes.
+    //!
+    //! @tparam Indexes Integral types, one for each virtual parameter.
+    //! @param indexes For each virtual parameter, the position of a class in
+    //! the corresponding list passed to the constructor.
+    //! @return A pointer to a function that takes the method's parameters.
+    template<class... Indexes>
+    auto operator()(Indexes... indexes) const -> function_pointer {
+        return overriders[offset(indexes...)];
+    }
+
+    //! Return the number of combinations.
+    //! @return The number of overriders in the table.
+    auto size() const noexcept -> std::size_t {
+        return overriders.size();
+    }
+};
+
+template<class Method>
+template<class... TypeIdRanges>
+routing_table<Method>::routing_table(const TypeIdRanges&... types) {
+    static_assert(
+        sizeof...(TypeIdRanges) == arity,
+        "routing_table requires one list of type_ids per virtual parameter");
+
+    using registry = typename Method::RegistryType;
+    using vptr_policy = typename registry::template policy<policies::vptr>;
+
+    registry::require_initialized();
+
+    std::vector<vptr_type> vptrs[arity];
+    std::size_t dimension = 0;
+    std::size_t count = 1;
+
+    auto add_dimension = [&](const auto& range) {
+        for (const auto& type : range) {
+            vptrs[dimension].push_back(vptr_policy::type_vptr(type));
+        }
+
+        sizes[dimension] = vptrs[dimension].size();
+        count *= sizes[dimension];
+        ++dimension;
+    };
+
+    (add_dimension(types), ...);
+
+    overriders.reserve(count);
+
+    // Walk the combinations in row-major order, like an odometer.
+    std::size_t indexes[arity] = {};
+    vptr_type args[arity];
+
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t d = 0; d < arity; ++d) {
+            args[d] = vptrs[d][indexes[d]];
+        }
+
+        overriders.push_back(
+            Method::fn.resolve_vptrs(args, std::make_index_sequence<arity>()));
+
+        for (std::size_t d = arity; d-- > 0;) {
+            if (++indexes[d] < sizes[d]) {
+                break;
+            }
+
+            indexes[d] = 0;
+        }
+    }
+}
+
+template<class Method>
+template<class... Indexes>
+auto routing_table<Method>::offset(Indexes... indexes) const -> std::size_t {
+    static_assert(
+        sizeof...(Indexes) == arity,
+        "routing_table requires one index per virtual parameter");
+
+    std::size_t result = 0;
+    std::size_t dimension = 0;
+
+    ((BOOST_ASSERT(std::size_t(indexes) < sizes[dimension]),
+      result = result * sizes[dimension++] + std::size_t(indexes)),
+     ...);
+
+    return result;
+}
+
+namespace aliases {
+using boost::openmethod::routing_table;
+} // namespace aliases
+
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,270 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_VIRTUAL_COLLECTION_HPP
+#define BOOST_OPENMETHOD_VIRTUAL_COLLECTION_HPP
+
+#include <boost/openmethod/core.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace boost::openmethod {
+
+namespace detail {
+
+// The objects of one class in a `virtual_collection`, described without
+// reference to their class, so `call` can walk them.
+struct collection_segment {
+    virtual ~collection_segment() = default;
+
+    const vptr_type* static_vptr = nullptr;
+    type_id type = nullptr;
+    char* first = nullptr;
+    std::size_t size = 0;
+    std::size_t stride = 0;
+    // Distance from an object to its `Base` subobject.
+    std::ptrdiff_t offset = 0;
+};
+
+template<class Class>
+struct collection_segment_of : collection_segment {
+    std::vector<Class> objects;
+};
+
+} // namespace detail
+
+//! Container that stores objects in contiguous segments, one per class.
+//!
+//! `virtual_collection` owns objects of classes derived from `Base`. The
+//! objects of the same class are stored contiguously, in a `std::vector`, and
+//! the segments are kept in the order in which their class was first
+//! inserted. As with `std::vector`, inserting an object may invalidate the
+//! references to the other objects of the same class.
+//!
+//! @ref call calls a method for each object in the collection. It selects the
+//! overrider once per segment, using the @ref registry::static_vptr of the
+//! segment's class, whatever the kind of the first parameter, then calls it
+//! directly for each object in the segment. Thus, the objects are read
+//! sequentially, and the calls are predictable.
+//!
+//! @par Requirements
+//!
+//! @li The classes of the objects must be registered in `Registry`.
+//!
+//! @tparam Base The base class of the objects.
+//! @tparam Registry The registry of the methods called on the objects.
+template<class Base, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY>
+class virtual_collection {
+    std::vector<std::unique_ptr<detail::collection_segment>> segments;
+    std::size_t count = 0;
+
+    template<class Class>
+    auto segment() -> detail::collection_segment_of<Class>&;
+
+    static auto object(const detail::collection_segment& seg, std::size_t i)
+        -> Base&;
+
+    template<class Argument>
+    static auto argument(const detail::collection_segment& seg, std::size_t i)
+        -> decltype(auto);
+
+  public:
+    //! Construct an object in the collection.
+    //!
+    //! @tparam Class The class of the object, derived from `Base`.
+    //! @tparam Args The types of the arguments of the constructor.
+    //! @param args The arguments of the constructor.
+    //! @return A reference to the new object.
+    template<class Class, class... Args>
+    auto emplace(Args&&... args) -> Class&;
+
+    //! Copy or move an object into the collection.
+    //!
+    //! @tparam Class The class of the object, derived from `Base`.
+    //! @param obj The object to insert.
+    //! @return A reference to the new object.
+    template<class Class>
+    auto insert(Class&& obj) -> std::decay_t<Class>& {
+        return emplace<std::decay_t<Class>>(std::forward<Class>(obj));
+    }
+
+    //! Call a method for each object in the collection.
+    //!
+    //! Passes each object as the first argument of the method, followed by
+    //! `args`. The first parameter of the method must be virtual, and accept a
+    //! `virtual_ptr`, a reference, or a pointer to `Base`. The values returned
+    //! by the method, if any, are discarded.
+    //!
+    //! The overrider is selected once per segment. The other virtual arguments,
+    //! if any, are the same for all the calls, so it is the same for all the
+    //! objects in the segment.
+    //!
+    //! `args` are passed to each call as lvalues. Thus, the parameters of the
+    //! method, after the first, cannot be rvalue references, and parameters
+    //! passed by value are copied once per object.
+    //!
+    //! @par Errors
+    //!
+    //! If `Registry` contains the @ref runtime_checks policy, and the class of
+    //! a segment is not registered, the registry's @ref error_handler, if it has
+    //! one, is called with a @ref missing_class error, then the program is
+    //! terminated with @ref abort.
+    //!
+    //! @param method The method to call, for example `Method::fn`.
+    //! @param args The remaining arguments of the method.
+    template<
+        class Id, typename ReturnType, class Parameter, class... Parameters>
+    auto call(
+        const method<Id, ReturnType(Parameter, Parameters...), Registry>&
+            method,
+        typename BOOST_OPENMETHOD_DETAIL_UNLESS_MRDOCS StripVirtualDecorator<
+            Parameters>::type... args) -> void;
+
+    //! Return the number of objects in the collection.
+    //! @return The number of objects.
+    auto size() const noexcept -> std::size_t {
+        return count;
+    }
+
+    //! Check if the collection is empty.
+    //! @return `true` if the collection contains no objects.
+    auto empty() const noexcept -> bool {
+        return count == 0;
+    }
+
+    //! Destroy all the objects in the collection.
+    auto clear() noexcept -> void {
+        segments.clear();
+        count = 0;
+    }
+};
+
+template<class Base, class Registry>
+template<class Class>
+auto virtual_collection<Base, Registry>::segment()
+    -> detail::collection_segment_of<Class>& {
+    const vptr_type* key = &Registry::template static_vptr<Class>;
+
+    for (auto& seg : segments) {
+        if (seg->static_vptr == key) {
+            return static_cast<detail::collection_segment_of<Class>&>(*seg);
+        }
+    }
+
+    auto seg = std::make_unique<detail::collection_segment_of<Class>>();
+    seg->static_vptr = key;
+    seg->type = Registry::rtti::template static_type<Class>();
+    seg->stride = sizeof(Class);
+    auto& result = *seg;
+    segments.push_back(std::move(seg));
+
+    return result;
+}
+
+template<class Base, class Registry>
+template<class Class, class... Args>
+auto virtual_collection<Base, Registry>::emplace(Args&&... args) -> Class& {
+    static_assert(
+        std::is_base_of_v<Base, Class>, "Class must be derived from Base");
+
+    auto& seg = segment<Class>();
+    auto& obj = seg.objects.emplace_back(std::forward<Args>(args)...);
+    seg.first = reinterpret_cast<char*>(seg.objects.data());
+    seg.size = seg.objects.size();
+    seg.offset = reinterpret_cast<char*>(static_cast<Base*>(&obj)) -
+        reinterpret_cast<char*>(&obj);
+    ++count;
+
+    return obj;
+}
+
+template<class Base, class Registry>
+auto virtual_collection<Base, Registry>::object(
+    const detail::collection_segment& seg, std::size_t i) -> Base& {
+    return *reinterpret_cast<Base*>(seg.first + i * seg.stride + seg.offset);
+}
+
+template<class Base, class Registry>
+template<class Argument>
+auto virtual_collection<Base, Registry>::argument(
+    const detail::collection_segment& seg, std::size_t i) -> decltype(auto) {
+    auto& obj = object(seg, i);
+
+    if constexpr (detail::is_virtual_ptr<Argument>) {
+        using Class = typename std::remove_cv_t<
+            std::remove_reference_t<Argument>>::element_type;
+
+        return virtual_ptr<Class, Registry>(
+            obj,
+            detail::box_vptr<Registry::has_indirect_vptr>(*seg.static_vptr));
+    } else if constexpr (std::is_pointer_v<Argument>) {
+        return &obj;
+    } else {
+        return static_cast<Base&>(obj);
+    }
+}
+
+template<class Base, class Registry>
+template<class Id, typename ReturnType, class Parameter, class... Parameters>
+auto virtual_collection<Base, Registry>::call(
+    const method<Id, ReturnType(Parameter, Parameters...), Registry>& method,
+    typename BOOST_OPENMETHOD_DETAIL_UNLESS_MRDOCS StripVirtualDecorator<
+        Parameters>::type... args) -> void {
+    using namespace detail;
+    using Argument = typename StripVirtualDecorator<Parameter>::type;
+
+    static_assert(
+        is_virtual<Parameter>::value,
+        "the first parameter of the method must be virtual");
+
+    static_assert(
+        !(std::is_rvalue_reference_v<
+              typename StripVirtualDecorator<Parameters>::type> ||
+          ...),
+        "the arguments are passed to each call as lvalues: the parameters "
+        "after the first cannot be rvalue references");
+
+    for (auto& seg : segments) {
+        if (seg->size == 0) {
+            continue;
+        }
+
+        if constexpr (Registry::has_runtime_checks) {
+            if (!*seg->static_vptr) {
+                if constexpr (Registry::has_error_handler) {
+                    missing_class error;
+                    error.type = seg->type;
+                    Registry::error_handler::error(error);
+                }
+
+                abort();
+            }
+        }
+
+        // Resolve from the segment's v-table, even if the first parameter is
+        // a reference or a pointer.
+        auto pf = method.resolve(
+            virtual_ptr<Base, Registry>(
+                object(*seg, 0),
+                box_vptr<Registry::has_indirect_vptr>(*seg->static_vptr)),
+            parameter_traits<Parameters, Registry>::peek(args)...);
+
+        for (std::size_t i = 0; i < seg->size; ++i) {
+            pf(argument<Argument>(*seg, i), args...);
+        }
+    }
+}
+
+namespace aliases {
+using boost::openmethod::virtual_collection;
+} // namespace aliases
+
+} // namespace boost::openmethod
+
+#endif
@@ -0,0 +1,245 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef BOOST_OPENMETHOD_VIRTUAL_VALUE_HPP
+#define BOOST_OPENMETHOD_VIRTUAL_VALUE_HPP
+
+#include <boost/openmethod/core.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace boost::openmethod {
+
+//! A value of an enumeration or integral type, as a class.
+//!
+//! `value_constant<V>` is the class of `V` when it is passed in a @ref
+//! virtual_value parameter. Overriders take a `value_constant` to specialize
+//! on a value.
+//!
+//! @tparam Value A value of an enumeration or integral type.
+template<auto Value>
+struct value_constant : std::integral_constant<decltype(Value), Value> {};
+
+//! A value used as a virtual argument.
+//!
+//! `virtual_value<Value, N>` wraps a value of an enumeration or integral type,
+//! in the range `[0, N)`. In a `virtual_` parameter, it dispatches on the
+//! value: each value `V` is a class, `value_constant<V>`, derived from
+//! `virtual_value<Value, N>`. Thus, a method can dispatch on the dynamic type
+//! of an object and on a value, for example an operation code, in a single
+//! call.
+//!
+//! The v-table pointer of a `virtual_value` is read from a table indexed by
+//! the value. No RTTI and no hashing are involved.
+//!
+//! @par Requirements
+//!
+//! @li The `virtual_value` must be registered with @ref use_values.
+//!
+//! @par Example
+//!
+//! @code
+//! enum class opcode { push, pop, count };
+//! using opcode_value = virtual_value<opcode, std::size_t(opcode::count)>;
+//! BOOST_OPENMETHOD_REGISTER(use_values<opcode_value>);
+//!
+//! BOOST_OPENMETHOD(
+//!     execute, (virtual_ptr<Stack>, virtual_<opcode_value>), void);
+//!
+//! BOOST_OPENMETHOD_OVERRIDE(
+//!     execute, (virtual_ptr<Stack> s, value_constant<opcode::pop>), void) {
+//!     s->pop();
+//! }
+//!
+//! execute(stack, opcode::pop);
+//! @endcode
+//!
+//! @tparam Value An enumeration or integral type.
+//! @tparam N The number of values.
+template<typename Value, std::size_t N>
+class virtual_value {
+    static_assert(
+        std::is_enum_v<Value> || std::is_integral_v<Value>,
+        "virtual_value requires an enumeration or integral type");
+    static_assert(N > 0, "virtual_value requires at least one value");
+
+    Value val;
+
+  public:
+    //! The type of the value.
+    using value_type = Value;
+
+    //! The number of values.
+    static constexpr std::size_t size = N;
+
+    //! Construct from a value.
+    //! @param value A value in the range `[0, N)`.
+    constexpr virtual_value(Value value) noexcept : val(value) {
+    }
+
+    //! Construct from a `value_constant`.
+    //! @tparam V A value in the range `[0, N)`.
+    template<Value V>
+    constexpr virtual_value(value_constant<V>) noexcept : val(V) {
+    }
+
+    //! Return the value.
+    //! @return The value.
+    constexpr auto value() const noexcept -> Value {
+        return val;
+    }
+
+    //! Return the value.
+    //! @return The value.
+    constexpr operator Value() const noexcept {
+        return val;
+    }
+};
+
+namespace detail {
+
+template<typename Value, class Registry, class Indexes>
+struct value_vptrs;
+
+template<typename Value, class Registry, std::size_t... I>
+struct value_vptrs<Value, Registry, std::index_sequence<I...>> {
+    static constexpr const vptr_type* table[] = {
+        &Registry::template static_vptr<
+            value_constant<static_cast<Value>(I)>>...};
+};
+
+template<class VirtualValue, class Registry, class Indexes>
+struct use_values_aux;
+
+template<typename Value, std::size_t N, class Registry, std::size_t... I>
+struct use_values_aux<
+    virtual_value<Value, N>, Registry, std::index_sequence<I...>> {
+    using Virtual = virtual_value<Value, N>;
+
+    use_class_aux<Registry, mp11::mp_list<Virtual, Virtual>> root;
+    std::tuple<use_class_aux<
+        Registry,
+        mp11::mp_list<
+            value_constant<static_cast<Value>(I)>,
+            value_constant<static_cast<Value>(I)>, Virtual>>...>
+        values;
+};
+
+} // namespace detail
+
+//! Return the v-table pointer for a `virtual_value`.
+//!
+//! If `Registry` contains the @ref runtime_checks policy, and the value is
+//! not in the range `[0, N)`, calls the registry's @ref error_handler, if it
+//! has one, with a @ref missing_class value, then terminates the program with
+//! @ref abort.
+//!
+//! @tparam Value An enumeration or integral type.
+//! @tparam N The number of values.
+//! @tparam Registry A @ref registry.
+//! @param arg A `virtual_value`.
+//! @return The v-table pointer for the `value_constant` of `arg`'s value.
+template<typename Value, std::size_t N, class Registry>
+auto boost_openmethod_vptr(const virtual_value<Value, N>& arg, Registry*)
+    -> vptr_type {
+    using vptrs = detail::value_vptrs<
+        Value, Registry, std::make_index_sequence<N>>;
+
+    auto index = static_cast<std::size_t>(arg.value());
+
+    if constexpr (Registry::has_runtime_checks) {
+        if (index >= N) {
+            if constexpr (Registry::has_error_handler) {
+                missing_class error;
+                error.type = Registry::rtti::template static_type<
+                    virtual_value<Value, N>>();
+                Registry::error_handler::error(error);
+            }
+
+            abort();
+        }
+    }
+
+    return *vptrs::table[index];
+}
+
+//! Specialize virtual_traits for `virtual_value`.
+//!
+//! The virtual type is the `virtual_value` itself. Overriders take a @ref
+//! value_constant, or the `virtual_value`.
+//!
+//! @tparam Value An enumeration or integral type.
+//! @tparam N The number of values.
+//! @tparam Registry A @ref registry.
+template<typename Value, std::size_t N, class Registry>
+struct virtual_traits<virtual_value<Value, N>, Registry> {
+    //! The `virtual_value` type.
+    using virtual_type = virtual_value<Value, N>;
+
+    //! Return a reference to a non-modifiable `virtual_value`.
+    //! @param arg A `virtual_value`.
+    //! @return A reference to `arg`.
+    static auto peek(const virtual_value<Value, N>& arg)
+        -> const virtual_value<Value, N>& {
+        return arg;
+    }
+
+    //! Convert to the overrider's parameter type.
+    //!
+    //! The value is not checked: the overrider was selected for it.
+    //!
+    //! @tparam Derived A `value_constant`, or the `virtual_value`.
+    //! @param arg A `virtual_value`.
+    //! @return A `Derived` object.
+    template<typename Derived>
+    static auto cast(virtual_value<Value, N> arg) -> Derived {
+        if constexpr (std::is_same_v<Derived, virtual_value<Value, N>>) {
+            return arg;
+        } else {
+            return Derived();
+        }
+    }
+};
+
+//! Specialize virtual_traits for `value_constant`.
+//!
+//! Makes `value_constant` usable in the overriders of methods that take a
+//! @ref virtual_value.
+//!
+//! @tparam Value A value of an enumeration or integral type.
+//! @tparam Registry A @ref registry.
+template<auto Value, class Registry>
+struct virtual_traits<value_constant<Value>, Registry> {
+    //! The `value_constant` type.
+    using virtual_type = value_constant<Value>;
+};
+
+//! Add a `virtual_value` and its values to a registry.
+//!
+//! `use_values` is a registrar class, like @ref use_classes. It registers the
+//! `virtual_value` as a class, and the @ref value_constant of each value in
+//! its range as a class derived from it.
+//!
+//! @tparam VirtualValue A @ref virtual_value type.
+//! @tparam Registry A @ref registry.
+template<class VirtualValue, class Registry = BOOST_OPENMETHOD_DEFAULT_REGISTRY>
+class use_values {
+    detail::use_values_aux<
+        VirtualValue, Registry, std::make_index_sequence<VirtualValue::size>>
+        values;
+};
+
+namespace aliases {
+using boost::openmethod::use_values;
+using boost::openmethod::value_constant;
+using boost::openmethod::virtual_value;
+} // namespace aliases
+
+} // namespace boost::openmethod
+
+#endif
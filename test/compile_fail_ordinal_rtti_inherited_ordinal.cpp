@@ -0,0 +1,28 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/policies/ordinal_rtti.hpp>
+
+using namespace boost::openmethod;
+
+struct ordinal_registry
+    : default_registry::with<policies::ordinal_rtti>::without<
+          policies::type_hash> {};
+
+struct Animal {
+    BOOST_OPENMETHOD_ORDINAL(ordinal_registry);
+
+    virtual ~Animal() = default;
+};
+
+// Missing BOOST_OPENMETHOD_ORDINAL: Dog would be dispatched as an Animal.
+struct Dog : Animal {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, ordinal_registry);
+
+int main() {
+    return 0;
+}
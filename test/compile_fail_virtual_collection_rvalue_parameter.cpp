@@ -0,0 +1,27 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/virtual_collection.hpp>
+
+#include <string>
+
+using namespace boost::openmethod;
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+BOOST_OPENMETHOD(poke, (virtual_ptr<Animal>, std::string&&), void);
+
+int main() {
+    virtual_collection<Animal> animals;
+    animals.call(
+        BOOST_OPENMETHOD_TYPE(
+            poke, (virtual_ptr<Animal>, std::string&&), void)::fn,
+        std::string());
+    return 0;
+}
@@ -0,0 +1,303 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#define BOOST_TEST_MODULE compact_virtual_ptr
+#include <boost/test/unit_test.hpp>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/compact_virtual_ptr.hpp>
+#include <boost/openmethod/initialize.hpp>
+#include <boost/openmethod/inplace_vptr.hpp>
+#include <boost/openmethod/policies/throw_error_handler.hpp>
+
+#include "test_util.hpp"
+
+namespace bom = boost::openmethod;
+using bom::compact_virtual_ptr;
+using bom::virtual_ptr;
+
+namespace test_compact_virtual_ptr {
+
+using direct_registry = test_registry_<__COUNTER__>;
+using indirect_registry =
+    test_registry_<__COUNTER__, bom::policies::indirect_vptr>;
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat final : Animal {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, direct_registry);
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, indirect_registry);
+
+template<class Registry>
+using name = bom::method<
+    Registry, auto(virtual_ptr<Animal, Registry>)->std::string, Registry>;
+
+template<class Registry>
+auto name_dog(virtual_ptr<Dog, Registry>) -> std::string {
+    return "dog";
+}
+
+template<class Registry>
+auto name_cat(virtual_ptr<Cat, Registry>) -> std::string {
+    return "cat";
+}
+
+BOOST_OPENMETHOD_REGISTER(
+    name<direct_registry>::override<
+        name_dog<direct_registry>, name_cat<direct_registry>>);
+
+BOOST_OPENMETHOD_REGISTER(
+    name<indirect_registry>::override<
+        name_dog<indirect_registry>, name_cat<indirect_registry>>);
+
+static_assert(
+    sizeof(compact_virtual_ptr<Animal, direct_registry>) == sizeof(void*));
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(
+    compact_virtual_ptr_dispatch, Registry,
+    decltype(std::tuple<direct_registry, indirect_registry>())) {
+    bom::initialize<Registry>();
+
+    Dog dog;
+    Cat cat;
+
+    std::vector<compact_virtual_ptr<Animal, Registry>> animals;
+    animals.emplace_back(dog);
+    animals.emplace_back(cat);
+    animals.push_back(compact_virtual_ptr<Animal, Registry>::final(dog));
+    animals.emplace_back(virtual_ptr<Animal, Registry>(cat));
+
+    BOOST_TEST(animals[0].get() == &dog);
+    BOOST_TEST(animals[1].get() == &cat);
+    BOOST_TEST((animals[2] == animals[0]));
+    BOOST_TEST((animals[3] == animals[1]));
+    BOOST_TEST(animals[0].vptr() == Registry::template static_vptr<Dog>);
+    BOOST_TEST(animals[1].vptr() == Registry::template static_vptr<Cat>);
+
+    auto check = [&]() {
+        BOOST_TEST(name<Registry>::fn(animals[0]) == "dog");
+        BOOST_TEST(name<Registry>::fn(animals[1]) == "cat");
+        BOOST_TEST(name<Registry>::fn(animals[2]) == "dog");
+        BOOST_TEST(name<Registry>::fn(animals[3]) == "cat");
+    };
+
+    check();
+
+    // The indexes survive initialize.
+    bom::initialize<Registry>();
+    check();
+
+    compact_virtual_ptr<Animal, Registry> null(nullptr);
+    BOOST_TEST(!null);
+    BOOST_TEST(null.get() == nullptr);
+    BOOST_TEST(null.vptr() == nullptr);
+
+    bom::virtual_ptr<Animal, Registry> plain_null = null;
+    BOOST_TEST(plain_null.get() == nullptr);
+}
+
+} // namespace test_compact_virtual_ptr
+
+namespace test_shared_vtbl {
+
+using direct_registry = test_registry_<__COUNTER__>;
+using indirect_registry =
+    test_registry_<__COUNTER__, bom::policies::indirect_vptr>;
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+
+// No overrider of its own: shares Dog's v-table.
+struct Bulldog : Dog {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Bulldog, direct_registry);
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Bulldog, indirect_registry);
+
+template<class Registry>
+using name = bom::method<
+    Registry, auto(virtual_ptr<Animal, Registry>)->std::string, Registry>;
+
+template<class Registry>
+auto name_dog(virtual_ptr<Dog, Registry>) -> std::string {
+    return "dog";
+}
+
+BOOST_OPENMETHOD_REGISTER(
+    name<direct_registry>::override<name_dog<direct_registry>>);
+
+BOOST_OPENMETHOD_REGISTER(
+    name<indirect_registry>::override<name_dog<indirect_registry>>);
+
+// Compares the packed object pointers and class indexes.
+template<class Registry>
+auto same_bits(
+    const compact_virtual_ptr<Animal, Registry>& a,
+    const compact_virtual_ptr<Animal, Registry>& b) -> bool {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(
+    compact_virtual_ptr_shared_vtbl, Registry,
+    decltype(std::tuple<direct_registry, indirect_registry>())) {
+    bom::initialize<Registry>();
+
+    BOOST_TEST_REQUIRE(
+        Registry::template static_vptr<Bulldog> ==
+        Registry::template static_vptr<Dog>);
+
+    // Each pointer holds the index of the object's class, although Dog and
+    // Bulldog have the same v-table pointer. Otherwise, a Bulldog could be
+    // dispatched as a Dog, or vice versa, after a call to initialize that
+    // gives Bulldog its own v-table, e.g. after loading a library that adds an
+    // overrider for Bulldog.
+    Dog dog;
+    Bulldog bulldog;
+    compact_virtual_ptr<Animal, Registry> from_object(bulldog);
+
+    auto check = [](auto& obj) {
+        auto expected = compact_virtual_ptr<Animal, Registry>::final(obj);
+        compact_virtual_ptr<Animal, Registry> from_object(obj);
+        compact_virtual_ptr<Animal, Registry> from_virtual_ptr{
+            virtual_ptr<Animal, Registry>(obj)};
+
+        BOOST_TEST(same_bits(from_object, expected));
+        BOOST_TEST(same_bits(from_virtual_ptr, expected));
+        BOOST_TEST(name<Registry>::fn(from_object) == "dog");
+    };
+
+    check(dog);
+    check(bulldog);
+
+    if constexpr (Registry::has_indirect_vptr) {
+        // The v-table pointer is read from the class, not from the table that
+        // initialize replaces.
+        virtual_ptr<Animal, Registry> converted = from_object;
+        bom::initialize<Registry>();
+        BOOST_TEST(name<Registry>::fn(converted) == "dog");
+    }
+}
+
+} // namespace test_shared_vtbl
+
+namespace test_inplace_vptr {
+
+using test_registry = test_registry_<__COUNTER__>;
+
+struct Animal : bom::inplace_vptr_base<Animal, test_registry> {};
+struct Dog : Animal, bom::inplace_vptr_derived<Dog, Animal> {};
+
+BOOST_OPENMETHOD(
+    name, (virtual_ptr<Animal, test_registry>), std::string, test_registry);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    name, (virtual_ptr<Animal, test_registry>), std::string) {
+    return "animal";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    name, (virtual_ptr<Dog, test_registry>), std::string) {
+    return "dog";
+}
+
+// The class index is obtained from the rtti policy, which sees the static type
+// of a non-polymorphic class. Like virtual_ptr, reject it.
+static_assert(!std::is_constructible_v<
+              compact_virtual_ptr<Animal, test_registry>, Animal&>);
+static_assert(!std::is_constructible_v<
+              compact_virtual_ptr<Animal, test_registry>,
+              const virtual_ptr<Animal, test_registry>&>);
+static_assert(
+    !std::is_constructible_v<virtual_ptr<Animal, test_registry>, Animal&>);
+
+BOOST_AUTO_TEST_CASE(compact_virtual_ptr_inplace_vptr) {
+    bom::initialize<test_registry>();
+
+    Dog dog;
+    auto p = compact_virtual_ptr<Animal, test_registry>::final(dog);
+    BOOST_TEST(name(p) == "dog");
+}
+
+} // namespace test_inplace_vptr
+
+namespace test_address_overflow {
+
+struct test_registry
+    : test_registry_<__COUNTER__>::with<
+          bom::policies::runtime_checks, bom::policies::throw_error_handler> {
+};
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, test_registry);
+
+BOOST_AUTO_TEST_CASE(compact_virtual_ptr_address_overflow) {
+    bom::initialize<test_registry>();
+
+    // Not dereferenced: final takes the class index from a static variable.
+    auto& animal = *reinterpret_cast<Animal*>(std::uintptr_t(1) << 52);
+
+    BOOST_CHECK_THROW(
+        (compact_virtual_ptr<Animal, test_registry>::final(animal)),
+        bom::compact_address_overflow);
+}
+
+} // namespace test_address_overflow
+
+namespace test_unused {
+
+using test_registry = test_registry_<__COUNTER__>;
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, test_registry);
+
+BOOST_OPENMETHOD(
+    poke, (virtual_ptr<Animal, test_registry>), void, test_registry);
+
+BOOST_OPENMETHOD_OVERRIDE(poke, (virtual_ptr<Dog, test_registry>), void) {
+}
+
+BOOST_AUTO_TEST_CASE(compact_virtual_ptr_unused) {
+    using registry = test_registry::registry_type;
+
+    bom::initialize<test_registry>();
+
+    // No compact_virtual_ptr in this registry: the tables are not built.
+    BOOST_TEST(bom::detail::compact_vptrs<registry>.empty());
+    BOOST_TEST(bom::detail::compact_type_indexes<registry>.empty());
+}
+
+} // namespace test_unused
+
+#else
+
+BOOST_AUTO_TEST_CASE(compact_virtual_ptr_unsupported) {
+}
+
+#endif
@@ -121,6 +121,9 @@ BOOST_AUTO_TEST_CASE(test_use_classes_linear) {
     auto d4 = get_class<D4>(comp);
     auto d5 = get_class<D5>(comp);
 
+    BOOST_TEST(comp.find_class(type_id(&typeid(D5))) == d5);
+    BOOST_TEST(comp.find_class(type_id(&typeid(int))) == nullptr);
+
     BOOST_CHECK_EQUAL(sstr(base->direct_bases), empty);
     BOOST_CHECK_EQUAL(sstr(base->direct_derived), sstr(d1));
     BOOST_CHECK_EQUAL(
@@ -431,3 +434,109 @@ BOOST_AUTO_TEST_CASE(test_assign_slots_a1_c1_b1) {
     BOOST_TEST(get_class<B>(comp)->first_slot == 2u);
     BOOST_TEST(get_class<B>(comp)->vtbl.size() == 1u);
 }
+
+/// ============================================================================
+// Test write_global_data.
+
+namespace test_share_identical_vtbls {
+
+using test_registry = test_registry_<__COUNTER__>;
+
+struct Animal {
+    virtual ~Animal() = default;
+};
+struct Dog : Animal {};
+struct Bulldog : Dog {};
+struct Cat : Animal {};
+
+BOOST_OPENMETHOD_REGISTER(use_classes<Animal, Dog, Bulldog, Cat, test_registry>);
+
+using poke = method<M<0>, auto(virtual_<Animal&>)->int, test_registry>;
+using meet =
+    method<M<1>, auto(virtual_<Animal&>, virtual_<Animal&>)->int, test_registry>;
+
+auto poke_animal(Animal&) {
+    return 1;
+}
+
+auto poke_dog(Dog&) {
+    return 2;
+}
+
+auto meet_animals(Animal&, Animal&) {
+    return 3;
+}
+
+auto meet_dogs(Dog&, Dog&) {
+    return 4;
+}
+
+BOOST_OPENMETHOD_REGISTER(poke::override<poke_animal, poke_dog>);
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dogs>);
+
+BOOST_AUTO_TEST_CASE(test_share_identical_vtbls) {
+    initialize<test_registry>();
+
+    using registry = test_registry::registry_type;
+    BOOST_TEST(registry::static_vptr<Bulldog> == registry::static_vptr<Dog>);
+    BOOST_TEST(registry::static_vptr<Cat> == registry::static_vptr<Animal>);
+    BOOST_TEST(registry::static_vptr<Cat> != registry::static_vptr<Dog>);
+
+    Animal animal;
+    Dog dog;
+    Bulldog bulldog;
+    Cat cat;
+
+    BOOST_TEST(poke::fn(animal) == 1);
+    BOOST_TEST(poke::fn(cat) == 1);
+    BOOST_TEST(poke::fn(dog) == 2);
+    BOOST_TEST(poke::fn(bulldog) == 2);
+    BOOST_TEST(meet::fn(cat, dog) == 3);
+    BOOST_TEST(meet::fn(dog, cat) == 3);
+    BOOST_TEST(meet::fn(bulldog, dog) == 4);
+    BOOST_TEST(meet::fn(dog, bulldog) == 4);
+}
+
+} // namespace test_share_identical_vtbls
+
+BOOST_AUTO_TEST_CASE(test_share_vtbl_prefix_and_suffix) {
+    using test_registry = test_registry_<__COUNTER__>;
+
+    /*
+    A1  B1
+     \  /
+      C1
+    */
+
+    struct A {
+        virtual ~A() = default;
+    };
+    struct B {
+        virtual ~B() = default;
+    };
+    struct C : A, B {};
+
+    BOOST_OPENMETHOD_REGISTER(use_classes<A, test_registry>);
+    BOOST_OPENMETHOD_REGISTER(use_classes<B, test_registry>);
+    BOOST_OPENMETHOD_REGISTER(use_classes<A, B, C, test_registry>);
+    ADD_METHOD(A);
+    ADD_METHOD(B);
+    ADD_METHOD(C);
+    auto comp = initialize<test_registry>();
+
+    // C's vtbl covers slots 0-2; A uses slot 0 and B slot 2, with the same
+    // contents
+    BOOST_TEST_REQUIRE(check(comp[m_A])->slots.size() == 1u);
+    BOOST_TEST(check(comp[m_A])->slots[0] == 0u);
+    BOOST_TEST_REQUIRE(check(comp[m_B])->slots.size() == 1u);
+    BOOST_TEST(check(comp[m_B])->slots[0] == 2u);
+    BOOST_TEST_REQUIRE(check(comp[m_C])->slots.size() == 1u);
+    BOOST_TEST(check(comp[m_C])->slots[0] == 1u);
+    BOOST_TEST(get_class<B>(comp)->first_slot == 2u);
+    BOOST_TEST(get_class<A>(comp)->vtbl_owner == get_class<C>(comp));
+    BOOST_TEST(get_class<B>(comp)->vtbl_owner == get_class<C>(comp));
+
+    using registry = test_registry::registry_type;
+    BOOST_TEST(registry::static_vptr<A> == registry::static_vptr<C>);
+    BOOST_TEST(registry::static_vptr<B> == registry::static_vptr<C>);
+}
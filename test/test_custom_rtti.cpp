@@ -9,6 +9,10 @@
 
 #include <boost/openmethod.hpp>
 #include <boost/openmethod/initialize.hpp>
+#include <boost/openmethod/policies/ordinal_rtti.hpp>
+#include <boost/openmethod/policies/throw_error_handler.hpp>
+
+#include <set>
 
 #include "test_util.hpp"
 
@@ -521,3 +525,131 @@ BOOST_AUTO_TEST_CASE(custom_rtti_deferred) {
 }
 
 } // namespace deferred_type_id
+
+namespace ordinal {
+
+using test_registry = test_registry_<
+    __COUNTER__, policies::ordinal_rtti>::registry_type::without<policies::
+                                                                     type_hash>;
+
+struct Animal {
+    BOOST_OPENMETHOD_ORDINAL(test_registry);
+
+    Animal(const char* name) : name(name) {
+    }
+
+    virtual ~Animal() = default;
+
+    const char* name;
+};
+
+struct Dog : Animal {
+    BOOST_OPENMETHOD_ORDINAL(test_registry);
+
+    using Animal::Animal;
+};
+
+struct Cat : Animal {
+    BOOST_OPENMETHOD_ORDINAL(test_registry);
+
+    using Animal::Animal;
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+BOOST_OPENMETHOD(
+    meet, (virtual_<Animal&>, virtual_<Animal&>, std::ostream&), void,
+    test_registry);
+
+BOOST_OPENMETHOD_OVERRIDE(meet, (Animal&, Animal&, std::ostream& os), void) {
+    os << "ignore";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(meet, (Dog & dog, Cat& cat, std::ostream& os), void) {
+    os << dog.name << " chases " << cat.name << ".";
+}
+
+BOOST_AUTO_TEST_CASE(custom_rtti_ordinal) {
+    using rtti = test_registry::rtti;
+
+    auto animal = std::size_t(rtti::static_type<Animal>());
+    auto dog = std::size_t(rtti::static_type<Dog>());
+    auto cat = std::size_t(rtti::static_type<Cat>());
+    BOOST_TEST(
+        (std::set<std::size_t>{animal, dog, cat} ==
+         std::set<std::size_t>{1, 2, 3}));
+
+    initialize<test_registry>();
+
+    // One entry per class, plus the unused ordinal 0.
+    BOOST_TEST(detail::vptr_vector_vptrs<test_registry>.size() == 4u);
+
+    Animal &&a = Dog("Snoopy"), &&b = Cat("Sylvester");
+    BOOST_TEST(std::size_t(rtti::dynamic_type(a)) == dog);
+    BOOST_TEST(std::size_t(rtti::dynamic_type(b)) == cat);
+
+    {
+        std::stringstream os;
+        meet(a, b, os);
+        BOOST_TEST(os.str() == "Snoopy chases Sylvester.");
+    }
+
+    {
+        std::stringstream os;
+        meet(b, a, os);
+        BOOST_TEST(os.str() == "ignore");
+    }
+
+#ifndef BOOST_NO_RTTI
+    {
+        std::stringstream os;
+        rtti::type_name(rtti::static_type<Dog>(), os);
+        BOOST_TEST(os.str() == "ordinal::Dog");
+    }
+#endif
+}
+
+} // namespace ordinal
+
+namespace ordinal_missing {
+
+using test_registry = test_registry_<
+    __COUNTER__, policies::ordinal_rtti,
+    policies::throw_error_handler>::registry_type::without<policies::
+                                                               type_hash>;
+
+struct Animal {
+    BOOST_OPENMETHOD_ORDINAL(test_registry);
+
+    virtual ~Animal() = default;
+};
+
+// Registered, but without an ordinal.
+struct Stone {
+    virtual ~Stone() = default;
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Stone, test_registry);
+
+BOOST_OPENMETHOD(poke, (virtual_<Animal&>), void, test_registry);
+
+BOOST_OPENMETHOD_OVERRIDE(poke, (Animal&), void) {
+}
+
+BOOST_AUTO_TEST_CASE(custom_rtti_ordinal_missing) {
+    using rtti = test_registry::rtti;
+
+    BOOST_TEST(rtti::is_ordinal(rtti::static_type<Animal>()));
+    BOOST_TEST(!rtti::is_ordinal(rtti::static_type<Stone>()));
+
+    try {
+        initialize<test_registry>();
+        BOOST_FAIL("should have thrown");
+    } catch (const missing_class& error) {
+        BOOST_TEST(error.type == rtti::static_type<Stone>());
+    } catch (...) {
+        BOOST_FAIL("wrong exception");
+    }
+}
+
+} // namespace ordinal_missing
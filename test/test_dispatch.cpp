@@ -8,13 +8,26 @@
 #include <string>
 #include <type_traits>
 #include <any>
+#include <optional>
 
 #include <boost/openmethod.hpp>
 #include <boost/openmethod/interop/std_shared_ptr.hpp>
 #include <boost/openmethod/interop/std_unique_ptr.hpp>
 #include <boost/openmethod/initialize.hpp>
 #include <boost/openmethod/policies/vptr_vector.hpp>
+#include <boost/openmethod/policies/vptr_map.hpp>
 #include <boost/openmethod/policies/throw_error_handler.hpp>
+#include <boost/openmethod/policies/decision_tree.hpp>
+#include <boost/openmethod/policies/narrow_cells.hpp>
+#include <boost/openmethod/policies/huge_pages.hpp>
+#include <boost/openmethod/policies/numa_replicas.hpp>
+#include <boost/openmethod/policies/minimal_perfect_hash.hpp>
+#include <boost/openmethod/policies/parallel_hash_search.hpp>
+#include <boost/openmethod/policies/stable_vtbls.hpp>
+#if defined(__GXX_ABI_VERSION)
+#include <boost/openmethod/policies/itanium_vptr.hpp>
+#include <boost/openmethod/policies/itanium_downcast.hpp>
+#endif
 
 #include "test_util.hpp"
 
@@ -448,3 +461,1432 @@ BOOST_AUTO_TEST_CASE(comma_in_return_type) {
 }
 
 } // namespace test_comma_in_return_type
+
+namespace test_decision_tree {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+struct Mouse : Animal {};
+
+using test_registry =
+    test_registry_<__COUNTER__, policies::decision_tree<0>>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, Mouse, test_registry);
+
+struct BOOST_OPENMETHOD_ID(encounter);
+using encounter = method<
+    BOOST_OPENMETHOD_ID(encounter),
+    auto(virtual_<Animal&>, virtual_<Animal&>, virtual_<Animal&>)
+        ->std::string,
+    test_registry>;
+
+auto encounter_animals(Animal&, Animal&, Animal&) -> std::string {
+    return "animals";
+}
+
+auto encounter_dogs(Dog&, Dog&, Dog&) -> std::string {
+    return "dogs";
+}
+
+auto encounter_cats(Cat&, Cat&, Cat&) -> std::string {
+    return "cats";
+}
+
+auto encounter_mice(Mouse&, Mouse&, Mouse&) -> std::string {
+    return "mice";
+}
+
+BOOST_OPENMETHOD_REGISTER(encounter::override<
+                          encounter_animals, encounter_dogs, encounter_cats,
+                          encounter_mice>);
+
+BOOST_AUTO_TEST_CASE(test_decision_tree) {
+    auto comp = initialize<test_registry>();
+
+    // 4 x 4 x 4 table, mostly filled with encounter_animals
+    auto m = comp[encounter::fn];
+    BOOST_TEST_REQUIRE(m != nullptr);
+    BOOST_TEST(m->dispatch_table.size() == 64u);
+    BOOST_TEST(!m->tree.empty());
+    BOOST_TEST(m->tree_size < m->dispatch_table.size());
+
+    Animal animal;
+    Dog dog;
+    Cat cat;
+    Mouse mouse;
+    std::pair<Animal*, std::string> animals[] = {
+        {&animal, "animals"}, {&dog, "dogs"}, {&cat, "cats"}, {&mouse, "mice"}};
+
+    for (auto& [a, a_name] : animals) {
+        for (auto& [b, b_name] : animals) {
+            for (auto& [c, c_name] : animals) {
+                auto expected =
+                    a == b && b == c ? a_name : std::string("animals");
+                BOOST_TEST(encounter::fn(*a, *b, *c) == expected);
+            }
+        }
+    }
+}
+
+} // namespace test_decision_tree
+
+namespace test_concrete_only {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+
+    virtual void breathe() = 0;
+};
+
+struct Mammal : Animal {};
+
+struct Dog : Mammal {
+    void breathe() override {
+    }
+};
+
+struct Cat : Mammal {
+    void breathe() override {
+    }
+};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_mammals(Mammal&, Mammal&) -> std::string {
+    return "sniff";
+}
+
+auto meet_dogs(Dog&, Dog&) -> std::string {
+    return "wag tail";
+}
+
+auto meet_cats(Cat&, Cat&) -> std::string {
+    return "purr";
+}
+
+template<class Meet>
+void check_meet() {
+    Dog dog;
+    Cat cat;
+
+    BOOST_TEST(Meet::fn(dog, dog) == "wag tail");
+    BOOST_TEST(Meet::fn(cat, cat) == "purr");
+    BOOST_TEST(Meet::fn(dog, cat) == "sniff");
+    BOOST_TEST(Meet::fn(cat, dog) == "sniff");
+}
+
+namespace unchecked {
+
+struct registry : test_registry_<__COUNTER__>::without<policies::runtime_checks> {
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Mammal, Dog, Cat, registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, registry>;
+
+BOOST_OPENMETHOD_REGISTER(
+    meet::override<meet_animals, meet_mammals, meet_dogs, meet_cats>);
+
+BOOST_AUTO_TEST_CASE(test_concrete_only) {
+    auto report = initialize<registry>(concrete_only()).report;
+
+    // 4 x 4 table without the option, Animal and Mammal are removed
+    BOOST_TEST(report.cells == 4u);
+    BOOST_TEST(report.dropped_cells == 12u);
+    BOOST_TEST(report.not_implemented == 0u);
+    BOOST_TEST(report.ambiguous == 0u);
+
+    check_meet<meet>();
+}
+
+} // namespace unchecked
+
+namespace checked {
+
+struct registry : test_registry_<__COUNTER__, policies::runtime_checks> {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Mammal, Dog, Cat, registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, registry>;
+
+BOOST_OPENMETHOD_REGISTER(
+    meet::override<meet_animals, meet_mammals, meet_dogs, meet_cats>);
+
+BOOST_AUTO_TEST_CASE(test_concrete_only_with_runtime_checks) {
+    auto report = initialize<registry>(concrete_only()).report;
+
+    // Animal and Mammal are gathered in a "not implemented" group
+    BOOST_TEST(report.cells == 9u);
+    BOOST_TEST(report.dropped_cells == 7u);
+    BOOST_TEST(report.not_implemented == 0u);
+    BOOST_TEST(report.ambiguous == 0u);
+
+    check_meet<meet>();
+}
+
+} // namespace checked
+
+} // namespace test_concrete_only
+
+namespace test_narrow_cells {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+struct Mouse : Animal {};
+
+auto chase_dog_animal(Dog&, Animal&) -> std::string {
+    return "bark";
+}
+
+auto chase_animal_mouse(Animal&, Mouse&) -> std::string {
+    return "squeak";
+}
+
+auto chase_cat_mouse(Cat&, Mouse&) -> std::string {
+    return "pounce";
+}
+
+auto chase_animals(Animal&, Animal&, Animal&) -> std::string {
+    return "animals";
+}
+
+auto chase_dogs(Dog&, Dog&, Dog&) -> std::string {
+    return "dogs";
+}
+
+auto chase_cats(Cat&, Cat&, Cat&) -> std::string {
+    return "cats";
+}
+
+auto chase_mice(Mouse&, Mouse&, Mouse&) -> std::string {
+    return "mice";
+}
+
+struct registry
+    : test_registry_<
+          __COUNTER__, policies::narrow_cells<std::uint32_t>,
+          policies::decision_tree<16>, policies::runtime_checks,
+          policies::throw_error_handler> {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, Mouse, registry);
+
+struct BOOST_OPENMETHOD_ID(chase);
+using chase = method<
+    BOOST_OPENMETHOD_ID(chase),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, registry>;
+
+BOOST_OPENMETHOD_REGISTER(
+    chase::override<chase_dog_animal, chase_animal_mouse, chase_cat_mouse>);
+
+// 64 cells, above the decision_tree threshold
+struct BOOST_OPENMETHOD_ID(chase3);
+using chase3 = method<
+    BOOST_OPENMETHOD_ID(chase3),
+    auto(virtual_<Animal&>, virtual_<Animal&>, virtual_<Animal&>)
+        ->std::string,
+    registry>;
+
+BOOST_OPENMETHOD_REGISTER(
+    chase3::override<chase_animals, chase_dogs, chase_cats, chase_mice>);
+
+BOOST_AUTO_TEST_CASE(test_narrow_cells) {
+    auto comp = initialize<registry>();
+
+    auto m = comp[chase3::fn];
+    BOOST_TEST_REQUIRE(m != nullptr);
+    BOOST_TEST(!m->tree.empty());
+
+    Animal animal;
+    Dog dog;
+    Cat cat;
+    Mouse mouse;
+
+    BOOST_TEST(chase::fn(dog, cat) == "bark");
+    BOOST_TEST(chase::fn(dog, animal) == "bark");
+    BOOST_TEST(chase::fn(cat, mouse) == "pounce");
+    BOOST_TEST(chase::fn(mouse, mouse) == "squeak");
+    BOOST_CHECK_THROW(chase::fn(cat, cat), no_overrider);
+    BOOST_CHECK_THROW(chase::fn(dog, mouse), ambiguous_call);
+
+    std::pair<Animal*, std::string> animals[] = {
+        {&animal, "animals"}, {&dog, "dogs"}, {&cat, "cats"}, {&mouse, "mice"}};
+
+    for (auto& [a, a_name] : animals) {
+        for (auto& [b, b_name] : animals) {
+            for (auto& [c, c_name] : animals) {
+                auto expected =
+                    a == b && b == c ? a_name : std::string("animals");
+                BOOST_TEST(chase3::fn(*a, *b, *c) == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_narrow_cells_overflow) {
+    using cells = policies::narrow_cells<std::uint8_t>::fn<registry>;
+
+    auto method_type = registry::rtti::static_type<chase>();
+    cells::check(method_type, 256);
+    BOOST_CHECK_THROW(
+        cells::check(method_type, 257), policies::too_many_overriders);
+}
+
+} // namespace test_narrow_cells
+
+namespace test_arena {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(Dog&, Cat&) -> std::string {
+    return "chase";
+}
+
+auto name_animal(Animal&) -> std::string {
+    return "animal";
+}
+
+auto name_dog(Dog&) -> std::string {
+    return "dog";
+}
+
+using test_registry = test_registry_<__COUNTER__>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+struct BOOST_OPENMETHOD_ID(name);
+using name = method<
+    BOOST_OPENMETHOD_ID(name), auto(virtual_<Animal&>)->std::string,
+    test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(name::override<name_animal, name_dog>);
+
+// With runtime checks, the index also holds type_ids.
+auto vptr_of(vptr_type vptr) -> const void* {
+    return vptr;
+}
+
+auto vptr_of(const detail::checked_vptr<vptr_type>& entry) -> const void* {
+    return entry.vptr;
+}
+
+// In the arena, the index is aligned on a cache line, and is immediately
+// followed by the v-tables.
+auto index_in_arena() -> bool {
+    auto& vptrs = detail::vptr_vector_vptrs<test_registry::registry_type>;
+    auto index = reinterpret_cast<std::uintptr_t>(vptrs.data());
+
+    if (index % 64 != 0) {
+        return false;
+    }
+
+    for (auto& entry : vptrs) {
+        auto vptr = vptr_of(entry);
+        auto vtbl = reinterpret_cast<std::uintptr_t>(vptr);
+
+        if (vptr && (vtbl < index || vtbl > index + 1024)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// arena_allocator recognizes the index by an address range recorded when the
+// dispatch data is built, not by reading the dispatch data, which may already
+// be destroyed when the index is destroyed at exit.
+auto index_in_recorded_block() -> bool {
+    auto& vptrs = detail::vptr_vector_vptrs<test_registry::registry_type>;
+
+    return detail::arena_state<test_registry::registry_type>::current.contains(
+        vptrs.data());
+}
+
+void check_calls() {
+    Animal animal;
+    Dog dog;
+    Cat cat;
+
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+    BOOST_TEST(name::fn(dog) == "dog");
+    BOOST_TEST(name::fn(cat) == "animal");
+    BOOST_TEST(name::fn(animal) == "animal");
+}
+
+BOOST_AUTO_TEST_CASE(test_arena) {
+    initialize<test_registry>(arena());
+    BOOST_TEST(index_in_arena());
+    BOOST_TEST(index_in_recorded_block());
+    check_calls();
+
+    initialize<test_registry>();
+    BOOST_TEST(!index_in_recorded_block());
+    check_calls();
+
+    initialize<test_registry>(arena());
+    BOOST_TEST(index_in_arena());
+    finalize<test_registry>();
+
+    initialize<test_registry>(arena());
+    BOOST_TEST(index_in_arena());
+    check_calls();
+
+    // The measuring pass uses the same options as the real pass.
+    initialize<test_registry>(
+        arena(), hash_multiplier{0}, parallel_hash_search{4});
+    BOOST_TEST(index_in_arena());
+    check_calls();
+}
+
+} // namespace test_arena
+
+namespace test_huge_pages {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(Dog&, Cat&) -> std::string {
+    return "chase";
+}
+
+using test_registry = test_registry_<__COUNTER__, policies::huge_pages<0>>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+BOOST_AUTO_TEST_CASE(test_huge_pages) {
+    using memory = test_registry::memory;
+    using policies::page_backing;
+
+    auto p = memory::allocate(100);
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(p) % 64 == 0u);
+#if defined(__linux__)
+    BOOST_TEST((memory::backing_of(p) != page_backing::free_store));
+#endif
+    std::fill_n(static_cast<char*>(p), 100, 0);
+    memory::deallocate(p, 100);
+
+    using small_memory =
+        policies::huge_pages<>::fn<test_registry::registry_type>;
+    p = small_memory::allocate(100);
+    BOOST_TEST((small_memory::backing_of(p) == page_backing::free_store));
+    small_memory::deallocate(p, 100);
+
+    Dog dog;
+    Cat cat;
+
+    initialize<test_registry>();
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+
+    initialize<test_registry>(arena());
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+
+    finalize<test_registry>();
+}
+
+} // namespace test_huge_pages
+
+namespace test_replication {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+struct Mouse : Animal {};
+
+auto encounter_animals(Animal&, Animal&, Animal&) -> std::string {
+    return "animals";
+}
+
+auto encounter_dogs(Dog&, Dog&, Dog&) -> std::string {
+    return "dogs";
+}
+
+auto encounter_cats(Cat&, Cat&, Cat&) -> std::string {
+    return "cats";
+}
+
+auto encounter_mice(Mouse&, Mouse&, Mouse&) -> std::string {
+    return "mice";
+}
+
+auto name_animal(Animal&) -> std::string {
+    return "animal";
+}
+
+auto name_dog(Dog&) -> std::string {
+    return "dog";
+}
+
+// Three replicas in the free store; the test selects the current one.
+struct fake_replicas : policies::replication {
+    static inline std::size_t current = 0;
+
+    template<class Registry>
+    struct fn {
+        static auto initialize() -> std::size_t {
+            return 3;
+        }
+
+        static auto allocate(std::size_t, std::size_t bytes) -> void* {
+            return ::operator new(bytes);
+        }
+
+        static auto deallocate(std::size_t, void* p, std::size_t) -> void {
+            ::operator delete(p);
+        }
+
+        static auto local_replica() -> std::size_t {
+            return current;
+        }
+    };
+};
+
+template<class Registry>
+struct methods {
+    struct BOOST_OPENMETHOD_ID(encounter);
+    using encounter = method<
+        BOOST_OPENMETHOD_ID(encounter),
+        auto(virtual_<Animal&>, virtual_<Animal&>, virtual_<Animal&>)
+            ->std::string,
+        Registry>;
+
+    struct BOOST_OPENMETHOD_ID(name);
+    using name = method<
+        BOOST_OPENMETHOD_ID(name), auto(virtual_<Animal&>)->std::string,
+        Registry>;
+
+    static inline use_classes<Animal, Dog, Cat, Mouse, Registry> classes;
+    static inline typename encounter::template override<
+        encounter_animals, encounter_dogs, encounter_cats, encounter_mice>
+        encounter_overriders;
+    static inline typename name::template override<name_animal, name_dog>
+        name_overriders;
+
+    static void check() {
+        Animal animal;
+        Dog dog;
+        Cat cat;
+        Mouse mouse;
+        std::pair<Animal*, std::string> animals[] = {
+            {&animal, "animals"},
+            {&dog, "dogs"},
+            {&cat, "cats"},
+            {&mouse, "mice"}};
+
+        for (auto& [a, a_name] : animals) {
+            for (auto& [b, b_name] : animals) {
+                for (auto& [c, c_name] : animals) {
+                    auto expected =
+                        a == b && b == c ? a_name : std::string("animals");
+                    BOOST_TEST(encounter::fn(*a, *b, *c) == expected);
+                }
+            }
+        }
+
+        BOOST_TEST(name::fn(dog) == "dog");
+        BOOST_TEST(name::fn(cat) == "animal");
+    }
+};
+
+using fake_registry =
+    test_registry_<__COUNTER__, fake_replicas, policies::decision_tree<0>>;
+template struct methods<fake_registry>;
+
+using numa_registry = test_registry_<__COUNTER__, policies::numa_replicas>;
+template struct methods<numa_registry>;
+
+BOOST_AUTO_TEST_CASE(test_replication) {
+    using test_registry = fake_registry;
+    using m = methods<test_registry>;
+    auto comp = initialize<test_registry>();
+    BOOST_TEST(!comp[m::encounter::fn]->tree.empty());
+
+    Dog dog;
+    std::vector<vptr_type> vptrs;
+
+    for (std::size_t replica = 0; replica < 3; ++replica) {
+        fake_replicas::current = replica;
+        m::check();
+        vptrs.push_back(virtual_ptr<Animal, test_registry>(dog).vptr());
+    }
+
+    BOOST_TEST(vptrs[0] != vptrs[1]);
+    BOOST_TEST(vptrs[0] != vptrs[2]);
+    BOOST_TEST(vptrs[1] != vptrs[2]);
+
+    initialize<test_registry>(arena());
+
+    for (std::size_t replica = 0; replica < 3; ++replica) {
+        fake_replicas::current = replica;
+        m::check();
+    }
+
+    fake_replicas::current = 0;
+    finalize<test_registry>();
+}
+
+BOOST_AUTO_TEST_CASE(test_numa_replicas) {
+    initialize<numa_registry>();
+    methods<numa_registry>::check();
+    finalize<numa_registry>();
+}
+
+} // namespace test_replication
+
+namespace test_minimal_perfect_hash {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(Dog&, Cat&) -> std::string {
+    return "chase";
+}
+
+using test_registry = test_registry_<
+    __COUNTER__, policies::minimal_perfect_hash, policies::runtime_checks>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+BOOST_AUTO_TEST_CASE(test_minimal_perfect_hash) {
+    Dog dog;
+    Cat cat;
+
+    initialize<test_registry>();
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+    BOOST_TEST(
+        detail::vptr_vector_vptrs<test_registry::registry_type>.size() == 3u);
+    finalize<test_registry>();
+}
+
+// Synthetic type_ids, spaced like `std::type_info` objects.
+struct fake_class {
+    const type_id* first;
+
+    auto type_id_begin() const {
+        return first;
+    }
+
+    auto type_id_end() const {
+        return first + 1;
+    }
+};
+
+struct fake_context {
+    std::vector<type_id> types;
+    std::vector<fake_class> classes;
+
+    template<class Option>
+    static constexpr bool has_option = false;
+
+    explicit fake_context(std::size_t n) : types(n) {
+        static std::vector<char> storage;
+        storage.resize(n * 24);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            types[i] = type_id(storage.data() + i * 24);
+        }
+
+        for (auto& type : types) {
+            classes.push_back(fake_class{&type});
+        }
+    }
+
+    auto classes_begin() const {
+        return classes.begin();
+    }
+
+    auto classes_end() const {
+        return classes.end();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_minimal_perfect_hash_sizes) {
+    using hash =
+        policies::minimal_perfect_hash::fn<test_registry::registry_type>;
+
+    for (std::size_t n : {1, 100, 10000, 100000}) {
+        fake_context ctx(n);
+        auto [min_value, max_value] = hash::initialize(ctx, std::tuple<>());
+        BOOST_TEST(min_value == 0u);
+        BOOST_TEST(max_value == n - 1);
+
+        std::vector<bool> seen(n);
+        std::size_t collisions = 0;
+
+        for (auto type : ctx.types) {
+            auto index = hash::hash(type);
+            collisions += seen[index];
+            seen[index] = true;
+        }
+
+        BOOST_TEST(collisions == 0u);
+    }
+
+    hash::finalize(std::tuple<>());
+}
+
+} // namespace test_minimal_perfect_hash
+
+namespace test_hash_search {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(Dog&, Cat&) -> std::string {
+    return "chase";
+}
+
+using test_registry = test_registry_<__COUNTER__>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+BOOST_AUTO_TEST_CASE(test_hash_search) {
+    using hash = test_registry::policy<policies::type_hash>;
+
+    Dog dog;
+    Cat cat;
+
+    initialize<test_registry>(parallel_hash_search{4});
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+
+    auto known = hash::factors();
+    initialize<test_registry>(known);
+    BOOST_TEST(hash::multiplier() == known.value);
+    BOOST_TEST(hash::factors().bits == known.bits);
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+
+    // A multiplier recorded for a larger table than a search would consider
+    // is not reused: falls back to a search, which finds a smaller table.
+    initialize<test_registry>();
+    auto searched = hash::factors();
+    auto stale = searched;
+    stale.bits += 4;
+    initialize<test_registry>(stale);
+    BOOST_TEST(hash::factors().bits == searched.bits);
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+
+    // Maps all the type_ids to the same bucket: falls back to a search.
+    initialize<test_registry>(hash_multiplier{0}, parallel_hash_search{4});
+    BOOST_TEST(hash::multiplier() != 0u);
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+
+    finalize<test_registry>();
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_hash_search_many_types) {
+    using hash = policies::fast_perfect_hash::fn<test_registry::registry_type>;
+
+    test_minimal_perfect_hash::fake_context ctx(10000);
+    auto [min_value, max_value] =
+        hash::initialize(ctx, std::tuple<parallel_hash_search>());
+
+    std::vector<bool> seen(max_value + 1);
+    std::size_t collisions = 0;
+
+    for (auto type : ctx.types) {
+        auto index = hash::hash(type);
+        BOOST_TEST_REQUIRE(index >= min_value);
+        BOOST_TEST_REQUIRE(index <= max_value);
+        collisions += seen[index];
+        seen[index] = true;
+    }
+
+    BOOST_TEST(collisions == 0u);
+    hash::finalize(std::tuple<>());
+}
+
+} // namespace test_hash_search
+
+#if defined(__GXX_ABI_VERSION)
+
+namespace test_itanium_vptr {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Property {
+    virtual ~Property() {
+    }
+};
+
+struct Dog : Property, Animal {};
+struct Cat : Property, Animal {};
+
+auto meet_animals(Animal&, Animal&) -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(Dog&, Cat&) -> std::string {
+    return "chase";
+}
+
+auto value_property(Property&) -> std::string {
+    return "property";
+}
+
+auto value_dog(Dog&) -> std::string {
+    return "dog";
+}
+
+// Counts the calls to `dynamic_type`.
+struct counting_rtti : policies::std_rtti {
+    static inline std::size_t calls = 0;
+
+    template<class Registry>
+    struct fn : policies::std_rtti::fn<Registry> {
+        template<class Class>
+        static auto dynamic_type(const Class& obj) -> type_id {
+            ++calls;
+
+            return policies::std_rtti::fn<Registry>::dynamic_type(obj);
+        }
+    };
+};
+
+using test_registry = test_registry_<
+    __COUNTER__, counting_rtti, policies::itanium_vptr,
+    policies::runtime_checks>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Property, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<Animal&>, virtual_<Animal&>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+struct BOOST_OPENMETHOD_ID(value);
+using value = method<
+    BOOST_OPENMETHOD_ID(value), auto(virtual_<Property&>)->std::string,
+    test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(value::override<value_property, value_dog>);
+
+BOOST_AUTO_TEST_CASE(test_itanium_vptr) {
+    Dog dog;
+    Cat cat;
+
+    initialize<test_registry>();
+    counting_rtti::calls = 0;
+
+    // Animal is a secondary base of Dog and Cat: their Animal subobjects have
+    // their own C++ v-tables, learnt on first use.
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+    BOOST_TEST(value::fn(dog) == "dog");
+    BOOST_TEST(value::fn(cat) == "property");
+    BOOST_TEST(counting_rtti::calls == 4u);
+
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(meet::fn(cat, dog) == "ignore");
+    BOOST_TEST(value::fn(dog) == "dog");
+    BOOST_TEST(value::fn(cat) == "property");
+    BOOST_TEST(counting_rtti::calls == 4u);
+
+    // The table is emptied by initialize.
+    initialize<test_registry>();
+    counting_rtti::calls = 0;
+    BOOST_TEST(meet::fn(dog, cat) == "chase");
+    BOOST_TEST(counting_rtti::calls == 2u);
+
+    finalize<test_registry>();
+}
+
+using indirect_registry = test_registry_<
+    __COUNTER__, counting_rtti, policies::itanium_vptr,
+    policies::indirect_vptr, policies::runtime_checks>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Property, Dog, Cat, indirect_registry);
+
+struct BOOST_OPENMETHOD_ID(indirect_meet);
+using indirect_meet = method<
+    BOOST_OPENMETHOD_ID(indirect_meet),
+    auto(virtual_ptr<Animal, indirect_registry>,
+         virtual_ptr<Animal, indirect_registry>)
+        ->std::string,
+    indirect_registry>;
+
+auto indirect_meet_animals(
+    virtual_ptr<Animal, indirect_registry>,
+    virtual_ptr<Animal, indirect_registry>) -> std::string {
+    return "ignore";
+}
+
+auto indirect_meet_dog_cat(
+    virtual_ptr<Dog, indirect_registry>, virtual_ptr<Cat, indirect_registry>)
+    -> std::string {
+    return "chase";
+}
+
+BOOST_OPENMETHOD_REGISTER(
+    indirect_meet::override<indirect_meet_animals, indirect_meet_dog_cat>);
+
+BOOST_AUTO_TEST_CASE(test_itanium_vptr_indirect) {
+    Dog dog;
+    Cat cat;
+
+    initialize<indirect_registry>();
+    counting_rtti::calls = 0;
+
+    virtual_ptr<Animal, indirect_registry> a(dog), b(cat);
+    BOOST_TEST(counting_rtti::calls == 2u);
+    BOOST_TEST(indirect_meet::fn(a, b) == "chase");
+
+    // The table holds pointers to the v-table pointers, which are updated in
+    // place by initialize.
+    initialize<indirect_registry>();
+    BOOST_TEST(indirect_meet::fn(a, b) == "chase");
+    BOOST_TEST(indirect_meet::fn(b, a) == "ignore");
+
+    virtual_ptr<Animal, indirect_registry> c(dog);
+    BOOST_TEST(indirect_meet::fn(c, b) == "chase");
+
+    finalize<indirect_registry>();
+}
+
+} // namespace test_itanium_vptr
+
+namespace test_itanium_downcast {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+
+    int legs = 4;
+};
+
+struct Mammal : virtual Animal {
+    std::string sound;
+};
+
+struct Pet : virtual Animal {
+    std::string name;
+};
+
+struct Dog : Mammal, Pet {};
+struct Cat : Pet, Mammal {};
+
+auto describe_animal(Animal&) -> std::string {
+    return "animal";
+}
+
+auto describe_mammal(Mammal& mammal) -> std::string {
+    return mammal.sound;
+}
+
+auto describe_dog(Dog& dog) -> std::string {
+    return dog.name + " " + dog.sound;
+}
+
+auto meet_pets(
+    std::shared_ptr<Pet> a, std::shared_ptr<Pet> b) -> std::string {
+    return a->name + " meets " + b->name;
+}
+
+// Counts the calls to `dynamic_cast_ref`.
+struct counting_rtti : policies::std_rtti {
+    static inline std::size_t casts = 0;
+
+    template<class Registry>
+    struct fn : policies::std_rtti::fn<Registry> {
+        template<typename D, typename B>
+        static auto dynamic_cast_ref(B&& obj) -> D {
+            ++casts;
+
+            return policies::std_rtti::fn<Registry>::template dynamic_cast_ref<
+                D>(std::forward<B>(obj));
+        }
+    };
+};
+
+using test_registry = test_registry_<
+    __COUNTER__, counting_rtti, policies::itanium_downcast>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Mammal, Pet, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(describe);
+using describe = method<
+    BOOST_OPENMETHOD_ID(describe), auto(virtual_<Animal&>)->std::string,
+    test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(
+    describe::override<describe_animal, describe_mammal, describe_dog>);
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_<std::shared_ptr<Animal>>, virtual_<std::shared_ptr<Animal>>)
+        ->std::string,
+    test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_pets>);
+
+BOOST_AUTO_TEST_CASE(test_itanium_downcast) {
+    static_assert(test_registry::has_downcast);
+
+    auto dog = std::make_shared<Dog>();
+    dog->sound = "woof";
+    dog->name = "Snoopy";
+    auto cat = std::make_shared<Cat>();
+    cat->sound = "meow";
+    cat->name = "Felix";
+
+    initialize<test_registry>();
+    counting_rtti::casts = 0;
+
+    BOOST_TEST(describe::fn(*dog) == "Snoopy woof");
+    BOOST_TEST(describe::fn(*cat) == "meow");
+    BOOST_TEST(meet::fn(dog, cat) == "Snoopy meets Felix");
+    BOOST_TEST(counting_rtti::casts == 4u);
+
+    // The distances are now known.
+    BOOST_TEST(describe::fn(*dog) == "Snoopy woof");
+    BOOST_TEST(describe::fn(*cat) == "meow");
+    BOOST_TEST(meet::fn(cat, dog) == "Felix meets Snoopy");
+    BOOST_TEST(counting_rtti::casts == 4u);
+
+    // The copies of the shared_ptrs passed to the overrider are gone.
+    BOOST_TEST(dog.use_count() == 1);
+
+    finalize<test_registry>();
+    initialize<test_registry>();
+    BOOST_TEST(describe::fn(*dog) == "Snoopy woof");
+    BOOST_TEST(counting_rtti::casts == 5u);
+
+    finalize<test_registry>();
+}
+
+} // namespace test_itanium_downcast
+
+#endif
+
+namespace test_flat_map {
+
+BOOST_AUTO_TEST_CASE(test_flat_map) {
+    using map = detail::flat_map<type_id, std::size_t>;
+
+    map m;
+    BOOST_TEST((m.find(type_id(0)) == m.end()));
+
+    // Keys spaced like the addresses of small objects, to exercise collisions
+    // in the low bits.
+    std::vector<char> storage(16 * 1000);
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        BOOST_TEST(m.emplace(type_id(&storage[16 * i]), i).second);
+    }
+
+    BOOST_TEST(!m.emplace(type_id(&storage[0]), 42).second);
+    BOOST_TEST(m.size() == 1000u);
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        auto iter = m.find(type_id(&storage[16 * i]));
+        BOOST_TEST_REQUIRE((iter != m.end()));
+        BOOST_TEST(iter->second == i);
+    }
+
+    BOOST_TEST((m.find(type_id(&storage[8])) == m.end()));
+    BOOST_TEST((m.find(type_id(0)) == m.end()));
+
+    m.clear();
+    BOOST_TEST(m.size() == 0u);
+    BOOST_TEST((m.find(type_id(&storage[0])) == m.end()));
+}
+
+} // namespace test_flat_map
+
+namespace test_checked_vptr {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+auto poke_animal(Animal&) -> std::string {
+    return "bite";
+}
+
+auto poke_dog(Dog&) -> std::string {
+    return "bark";
+}
+
+// Cat is not registered.
+using test_registry = test_registry_<
+    __COUNTER__, policies::runtime_checks, policies::throw_error_handler>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, test_registry);
+
+struct BOOST_OPENMETHOD_ID(poke);
+using poke = method<
+    BOOST_OPENMETHOD_ID(poke), auto(virtual_<Animal&>)->std::string,
+    test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(poke::override<poke_animal, poke_dog>);
+
+BOOST_AUTO_TEST_CASE(test_checked_vptr) {
+    static_assert(
+        detail::vptr_vector_checks_type<test_registry::registry_type>);
+
+    Animal animal;
+    Dog dog;
+    Cat cat;
+
+    initialize<test_registry>();
+
+    auto& vptrs = detail::vptr_vector_vptrs<test_registry::registry_type>;
+    auto entry = vptrs[policies::fast_perfect_hash::fn<
+        test_registry::registry_type>::hash(type_id(&typeid(Dog)))];
+    BOOST_TEST(entry.type == type_id(&typeid(Dog)));
+    BOOST_TEST(entry.vptr == test_registry::static_vptr<Dog>);
+
+    BOOST_TEST(poke::fn(animal) == "bite");
+    BOOST_TEST(poke::fn(dog) == "bark");
+    BOOST_CHECK_THROW(poke::fn(cat), missing_class);
+
+    finalize<test_registry>();
+}
+
+} // namespace test_checked_vptr
+
+namespace test_leaf_classes {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat final : Animal {};
+struct Bulldog : Dog {};
+
+// Counts the calls to `dynamic_vptr`.
+struct counting_vptr : policies::vptr_vector {
+    static inline std::size_t calls = 0;
+
+    template<class Registry>
+    struct fn : policies::vptr_vector::fn<Registry> {
+        template<class Class>
+        static auto dynamic_vptr(const Class& arg) -> const vptr_type& {
+            ++calls;
+
+            return policies::vptr_vector::fn<Registry>::dynamic_vptr(arg);
+        }
+    };
+};
+
+using test_registry = test_registry_<__COUNTER__, counting_vptr>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, Bulldog, test_registry);
+
+auto name_animal(virtual_ptr<Animal, test_registry>) -> std::string {
+    return "animal";
+}
+
+auto name_dog(virtual_ptr<Dog, test_registry>) -> std::string {
+    return "dog";
+}
+
+auto name_cat(virtual_ptr<Cat, test_registry>) -> std::string {
+    return "cat";
+}
+
+struct BOOST_OPENMETHOD_ID(name);
+using name = method<
+    BOOST_OPENMETHOD_ID(name),
+    auto(virtual_ptr<Animal, test_registry>)->std::string, test_registry>;
+
+BOOST_OPENMETHOD_REGISTER(name::override<name_animal, name_dog, name_cat>);
+
+// Acquires the v-table pointer of `obj`, using its static type.
+template<class Class>
+auto call_name(Class& obj) -> std::string {
+    return name::fn(virtual_ptr<Class, test_registry>(obj));
+}
+
+BOOST_AUTO_TEST_CASE(test_leaf_classes) {
+    Animal animal;
+    Dog dog;
+    Cat cat;
+    Bulldog bulldog;
+
+    initialize<test_registry>();
+
+    BOOST_TEST(!test_registry::is_leaf<Animal>);
+    BOOST_TEST(!test_registry::is_leaf<Dog>);
+    BOOST_TEST(test_registry::is_leaf<Cat>);
+    BOOST_TEST(test_registry::is_leaf<Bulldog>);
+
+    counting_vptr::calls = 0;
+    BOOST_TEST(call_name(animal) == "animal");
+    BOOST_TEST(call_name(dog) == "dog");
+    BOOST_TEST(counting_vptr::calls == 2u);
+
+    // Cat is final, Bulldog is a leaf.
+    BOOST_TEST(call_name(cat) == "cat");
+    BOOST_TEST(call_name(bulldog) == "dog");
+
+    if constexpr (test_registry::has_runtime_checks) {
+        // The dynamic types were compared with the static types.
+        BOOST_TEST(counting_vptr::calls == 2u);
+    } else {
+        // Only the final class was known to be its own dynamic type.
+        BOOST_TEST(counting_vptr::calls == 3u);
+    }
+
+    finalize<test_registry>();
+}
+
+} // namespace test_leaf_classes
+
+namespace test_stable_vtbls {
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+struct Bulldog : Dog {};
+
+using test_registry =
+    test_registry_<__COUNTER__, policies::stable_vtbls<64 * 1024>>;
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, test_registry);
+
+struct BOOST_OPENMETHOD_ID(name);
+using name = method<
+    BOOST_OPENMETHOD_ID(name),
+    auto(virtual_ptr<Animal, test_registry>)->std::string, test_registry>;
+
+struct BOOST_OPENMETHOD_ID(meet);
+using meet = method<
+    BOOST_OPENMETHOD_ID(meet),
+    auto(virtual_ptr<Animal, test_registry>, virtual_ptr<Animal, test_registry>)
+        ->std::string,
+    test_registry>;
+
+auto name_animal(virtual_ptr<Animal, test_registry>) -> std::string {
+    return "animal";
+}
+
+auto name_dog(virtual_ptr<Dog, test_registry>) -> std::string {
+    return "dog";
+}
+
+auto name_cat(virtual_ptr<Cat, test_registry>) -> std::string {
+    return "cat";
+}
+
+auto meet_animals(
+    virtual_ptr<Animal, test_registry>, virtual_ptr<Animal, test_registry>)
+    -> std::string {
+    return "ignore";
+}
+
+auto meet_dog_cat(
+    virtual_ptr<Dog, test_registry>, virtual_ptr<Cat, test_registry>)
+    -> std::string {
+    return "chase";
+}
+
+BOOST_OPENMETHOD_REGISTER(name::override<name_animal, name_dog, name_cat>);
+BOOST_OPENMETHOD_REGISTER(meet::override<meet_animals, meet_dog_cat>);
+
+BOOST_AUTO_TEST_CASE(test_stable_vtbls) {
+    Dog dog;
+    Cat cat;
+    Bulldog bulldog;
+
+    initialize<test_registry>();
+
+    auto dog_vptr = test_registry::static_vptr<Dog>;
+    auto cat_vptr = test_registry::static_vptr<Cat>;
+    virtual_ptr<Animal, test_registry> vdog(dog), vcat(cat);
+    BOOST_TEST(vdog.vptr() == dog_vptr);
+    BOOST_TEST(meet::fn(vdog, vcat) == "chase");
+
+    {
+        // Simulate loading a library that adds a class. Registration objects
+        // must be in zero-initialized static storage.
+        static std::optional<use_classes<Bulldog, Dog, test_registry>>
+            bulldog_class;
+        bulldog_class.emplace();
+
+        initialize<test_registry>();
+
+        BOOST_TEST(test_registry::static_vptr<Dog> == dog_vptr);
+        BOOST_TEST(test_registry::static_vptr<Cat> == cat_vptr);
+
+        virtual_ptr<Animal, test_registry> vbulldog(bulldog);
+        BOOST_TEST(name::fn(vdog) == "dog");
+        BOOST_TEST(name::fn(vcat) == "cat");
+        BOOST_TEST(name::fn(vbulldog) == "dog");
+        BOOST_TEST(meet::fn(vdog, vcat) == "chase");
+        BOOST_TEST(meet::fn(vbulldog, vcat) == "chase");
+        BOOST_TEST(meet::fn(vcat, vbulldog) == "ignore");
+
+        // Simulate unloading the library.
+        bulldog_class.reset();
+    }
+
+    initialize<test_registry>();
+
+    BOOST_TEST(test_registry::static_vptr<Dog> == dog_vptr);
+    BOOST_TEST(name::fn(vdog) == "dog");
+    BOOST_TEST(meet::fn(vdog, vcat) == "chase");
+    BOOST_TEST(meet::fn(vcat, vdog) == "ignore");
+
+    finalize<test_registry>();
+}
+
+template<class Registry>
+void check_moved_vtbl() {
+    using storage = typename Registry::vtbl_storage;
+
+    static int dog_key;
+    auto dog_type = Registry::rtti::template static_type<Dog>();
+    policies::vtbl_placement placement{&dog_key, dog_type, 2, 3, nullptr};
+
+    storage::place(&placement, &placement + 1);
+    auto vptr = placement.vptr;
+
+    storage::place(&placement, &placement + 1);
+    BOOST_TEST(placement.vptr == vptr);
+
+    // A method was added to a base class: the v-table does not fit anymore.
+    ++placement.size;
+
+    try {
+        storage::place(&placement, &placement + 1);
+        BOOST_FAIL("should have thrown");
+    } catch (const policies::moved_vtbl& error) {
+        BOOST_TEST(error.type == dog_type);
+    } catch (...) {
+        BOOST_FAIL("wrong exception");
+    }
+
+    storage::finalize(std::tuple<>());
+}
+
+BOOST_AUTO_TEST_CASE(test_stable_vtbls_moved) {
+    check_moved_vtbl<test_registry_<
+        __COUNTER__, policies::stable_vtbls<64 * 1024, 0>,
+        policies::runtime_checks, policies::throw_error_handler>>();
+}
+
+BOOST_AUTO_TEST_CASE(test_stable_vtbls_moved_default_error_handler) {
+    using registry = test_registry_<
+        __COUNTER__, policies::stable_vtbls<64 * 1024, 0>,
+        policies::runtime_checks>;
+    using error_handler = registry::error_handler;
+
+    auto prev = error_handler::set(
+        [](const error_handler::error_variant& error) {
+            std::visit([](auto&& arg) { throw arg; }, error);
+        });
+
+    check_moved_vtbl<registry>();
+
+    error_handler::set(prev);
+}
+
+} // namespace test_stable_vtbls
@@ -199,3 +199,84 @@ BOOST_AUTO_TEST_CASE(core_intrusive_vptr) {
     indirect_policy::static_vptr<Indirect> = nullptr;
     BOOST_TEST(boost_openmethod_vptr(i, nullptr) == nullptr);
 }
+
+namespace test_compact_inplace_vptr {
+
+template<class Key>
+struct unique {
+    using category = unique;
+    template<class Registry>
+    struct fn {};
+};
+
+struct direct_registry : test_registry::with<unique<direct_registry>> {};
+
+struct indirect_registry
+    : test_registry::with<
+          unique<indirect_registry>, bom::policies::indirect_vptr> {};
+
+template<class Registry>
+struct Shape : bom::compact_inplace_vptr_base<Shape<Registry>, Registry> {
+    std::uint32_t id = 0;
+};
+
+template<class Registry>
+struct Circle : Shape<Registry>,
+                bom::inplace_vptr_derived<Circle<Registry>, Shape<Registry>> {
+};
+
+template<class Registry>
+using name = bom::method<
+    Shape<Registry>, auto(virtual_<const Shape<Registry>&>)->std::string,
+    Registry>;
+
+template<class Registry>
+auto name_shape(const Shape<Registry>&) -> std::string {
+    return "shape";
+}
+
+template<class Registry>
+auto name_circle(const Circle<Registry>&) -> std::string {
+    return "circle";
+}
+
+BOOST_OPENMETHOD_REGISTER(
+    name<direct_registry>::override<
+        name_shape<direct_registry>, name_circle<direct_registry>>);
+
+BOOST_OPENMETHOD_REGISTER(
+    name<indirect_registry>::override<
+        name_shape<indirect_registry>, name_circle<indirect_registry>>);
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(
+    compact_inplace_vptr, Registry,
+    decltype(std::tuple<direct_registry, indirect_registry>())) {
+    static_assert(sizeof(Shape<Registry>) == 2 * sizeof(std::uint32_t));
+
+    bom::initialize<Registry>();
+
+    Shape<Registry> shape;
+    Circle<Registry> circle;
+
+    BOOST_TEST(
+        boost_openmethod_vptr(shape, nullptr) ==
+        Registry::template static_vptr<Shape<Registry>>);
+    BOOST_TEST(
+        boost_openmethod_vptr(circle, nullptr) ==
+        Registry::template static_vptr<Circle<Registry>>);
+    BOOST_TEST(name<Registry>::fn(shape) == "shape");
+    BOOST_TEST(name<Registry>::fn(circle) == "circle");
+
+    if constexpr (Registry::has_indirect_vptr) {
+        // The objects need not be updated after initialize.
+        bom::initialize<Registry>();
+
+        BOOST_TEST(
+            boost_openmethod_vptr(circle, nullptr) ==
+            Registry::template static_vptr<Circle<Registry>>);
+        BOOST_TEST(name<Registry>::fn(shape) == "shape");
+        BOOST_TEST(name<Registry>::fn(circle) == "circle");
+    }
+}
+
+} // namespace test_compact_inplace_vptr
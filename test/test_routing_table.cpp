@@ -0,0 +1,179 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/routing_table.hpp>
+#include <boost/openmethod/policies/vptr_map.hpp>
+#include <boost/openmethod/initialize.hpp>
+
+#define BOOST_TEST_MODULE routing_table
+#include <boost/test/unit_test.hpp>
+
+#include "test_util.hpp"
+
+namespace bom = boost::openmethod;
+using bom::routing_table;
+using bom::type_id;
+using bom::virtual_ptr;
+
+namespace test_routing_table {
+
+using vector_registry = test_registry_<__COUNTER__>;
+using map_registry = test_registry_<__COUNTER__, bom::policies::vptr_map<>>;
+
+struct Message {
+    virtual ~Message() {
+    }
+};
+
+struct Login : Message {};
+struct Logout : Message {};
+
+struct Handler {
+    virtual ~Handler() {
+    }
+};
+
+struct Audit : Handler {};
+struct Forward : Handler {};
+
+BOOST_OPENMETHOD_CLASSES(
+    Message, Login, Logout, Handler, Audit, Forward, vector_registry);
+BOOST_OPENMETHOD_CLASSES(
+    Message, Login, Logout, Handler, Audit, Forward, map_registry);
+
+template<class Registry>
+using name = bom::method<
+    Registry, auto(virtual_ptr<Message, Registry>)->std::string, Registry>;
+
+template<class Registry>
+auto name_login(virtual_ptr<Login, Registry>) -> std::string {
+    return "login";
+}
+
+template<class Registry>
+auto name_logout(virtual_ptr<Logout, Registry>) -> std::string {
+    return "logout";
+}
+
+struct handle_id;
+
+template<class Registry>
+using handle = bom::method<
+    handle_id,
+    auto(virtual_ptr<Message, Registry>, int, virtual_ptr<Handler, Registry>)
+        ->std::string,
+    Registry>;
+
+template<class Registry>
+auto handle_any(
+    virtual_ptr<Message, Registry>, int n, virtual_ptr<Handler, Registry>)
+    -> std::string {
+    return "any " + std::to_string(n);
+}
+
+template<class Registry>
+auto audit_login(
+    virtual_ptr<Login, Registry>, int n, virtual_ptr<Audit, Registry>)
+    -> std::string {
+    return "audit login " + std::to_string(n);
+}
+
+template<class Registry>
+auto forward_message(
+    virtual_ptr<Message, Registry>, int n, virtual_ptr<Forward, Registry>)
+    -> std::string {
+    return "forward " + std::to_string(n);
+}
+
+BOOST_OPENMETHOD_REGISTER(
+    name<vector_registry>::override<
+        name_login<vector_registry>, name_logout<vector_registry>>);
+BOOST_OPENMETHOD_REGISTER(
+    name<map_registry>::override<
+        name_login<map_registry>, name_logout<map_registry>>);
+
+BOOST_OPENMETHOD_REGISTER(
+    handle<vector_registry>::override<
+        handle_any<vector_registry>, audit_login<vector_registry>,
+        forward_message<vector_registry>>);
+BOOST_OPENMETHOD_REGISTER(
+    handle<map_registry>::override<
+        handle_any<map_registry>, audit_login<map_registry>,
+        forward_message<map_registry>>);
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(
+    test_resolve_types, Registry,
+    decltype(std::tuple<vector_registry, map_registry>())) {
+    bom::initialize<Registry>();
+
+    using rtti = typename Registry::rtti;
+    auto login = rtti::template static_type<Login>();
+    auto logout = rtti::template static_type<Logout>();
+    auto audit = rtti::template static_type<Audit>();
+    auto forward = rtti::template static_type<Forward>();
+
+    Login login_obj;
+    Logout logout_obj;
+    Audit audit_obj;
+    Forward forward_obj;
+
+    BOOST_TEST(
+        name<Registry>::fn.resolve_types(login)(login_obj) == "login");
+    BOOST_TEST(
+        name<Registry>::fn.resolve_types(logout)(logout_obj) == "logout");
+
+    auto& handle_fn = handle<Registry>::fn;
+    BOOST_TEST(
+        handle_fn.resolve_types(login, audit)(login_obj, 1, audit_obj) ==
+        "audit login 1");
+    BOOST_TEST(
+        handle_fn.resolve_types(logout, audit)(logout_obj, 2, audit_obj) ==
+        "any 2");
+    BOOST_TEST(
+        handle_fn.resolve_types(logout, forward)(
+            logout_obj, 3, forward_obj) == "forward 3");
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(
+    test_routing_table, Registry,
+    decltype(std::tuple<vector_registry, map_registry>())) {
+    bom::initialize<Registry>();
+
+    using rtti = typename Registry::rtti;
+    std::vector<type_id> messages{
+        rtti::template static_type<Login>(),
+        rtti::template static_type<Logout>()};
+    std::vector<type_id> handlers{
+        rtti::template static_type<Audit>(),
+        rtti::template static_type<Forward>(),
+        rtti::template static_type<Handler>()};
+
+    routing_table<handle<Registry>> routes(messages, handlers);
+    BOOST_TEST(routes.size() == 6u);
+
+    Login login;
+    Logout logout;
+    Audit audit;
+    Forward forward;
+    Handler handler;
+
+    BOOST_TEST(routes(0, 0)(login, 1, audit) == "audit login 1");
+    BOOST_TEST(routes(0, 1)(login, 2, forward) == "forward 2");
+    BOOST_TEST(routes(0, 2)(login, 3, handler) == "any 3");
+    BOOST_TEST(routes(1, 0)(logout, 4, audit) == "any 4");
+    BOOST_TEST(routes(1, 1)(logout, 5, forward) == "forward 5");
+    BOOST_TEST(routes(1, 2)(logout, 6, handler) == "any 6");
+
+    routing_table<name<Registry>> names(messages);
+    BOOST_TEST(names.size() == 2u);
+    BOOST_TEST(names(1)(logout) == "logout");
+}
+
+} // namespace test_routing_table
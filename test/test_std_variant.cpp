@@ -0,0 +1,103 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <string>
+#include <variant>
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/interop/std_variant.hpp>
+#include <boost/openmethod/initialize.hpp>
+
+#define BOOST_TEST_MODULE std_variant
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::openmethod;
+
+namespace test_std_variant {
+
+struct Circle {
+    double r;
+};
+
+struct Square {
+    double side;
+};
+
+struct Triangle {
+    double base, height;
+};
+
+using Shape = std::variant<Circle, Square, Triangle>;
+
+BOOST_OPENMETHOD_REGISTER(use_variant<Shape>);
+
+BOOST_OPENMETHOD(name, (virtual_<const Shape&>), std::string);
+
+BOOST_OPENMETHOD_OVERRIDE(name, (const Shape&), std::string) {
+    return "shape";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(name, (const Circle&), std::string) {
+    return "circle";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(name, (const Square&), std::string) {
+    return "square";
+}
+
+BOOST_OPENMETHOD(
+    overlap, (virtual_<const Shape&>, virtual_<const Shape&>), std::string);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    overlap, (const Shape&, const Shape&), std::string) {
+    return "shape-shape";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    overlap, (const Circle& a, const Square& b), std::string) {
+    return "circle-square " + std::to_string(int(a.r + b.side));
+}
+
+// Overriders for non-const variants cannot be located by
+// BOOST_OPENMETHOD_OVERRIDE, because an alternative does not bind to a
+// reference to a non-const variant.
+struct scale_id;
+using scale = method<scale_id, auto(virtual_<Shape&>, double)->void>;
+
+auto scale_circle(Circle& circle, double factor) -> void {
+    circle.r *= factor;
+}
+
+auto scale_square(Square& square, double factor) -> void {
+    square.side *= factor;
+}
+
+BOOST_OPENMETHOD_REGISTER(scale::override<scale_circle, scale_square>);
+
+BOOST_AUTO_TEST_CASE(test_std_variant) {
+    initialize();
+
+    Shape circle = Circle{1};
+    Shape square = Square{2};
+    Shape triangle = Triangle{3, 4};
+
+    BOOST_TEST(name(circle) == "circle");
+    BOOST_TEST(name(square) == "square");
+    BOOST_TEST(name(triangle) == "shape");
+
+    BOOST_TEST(overlap(circle, square) == "circle-square 3");
+    BOOST_TEST(overlap(square, circle) == "shape-shape");
+
+    scale::fn(circle, 3);
+    scale::fn(square, 2);
+    BOOST_TEST(std::get<Circle>(circle).r == 3);
+    BOOST_TEST(std::get<Square>(square).side == 4);
+
+    // The variant's v-table pointer follows the alternative.
+    circle = Square{1};
+    BOOST_TEST(name(circle) == "square");
+}
+
+} // namespace test_std_variant
@@ -0,0 +1,244 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/virtual_collection.hpp>
+#include <boost/openmethod/initialize.hpp>
+#include <boost/openmethod/policies/throw_error_handler.hpp>
+
+#include <string>
+
+#define BOOST_TEST_MODULE virtual_collection
+#include <boost/test/unit_test.hpp>
+
+#include "test_util.hpp"
+
+using namespace boost::openmethod;
+
+namespace test_virtual_collection {
+
+struct Animal {
+    explicit Animal(std::string name) : name(std::move(name)) {
+    }
+
+    virtual ~Animal() {
+    }
+
+    std::string name;
+};
+
+struct Tagged {
+    int tag = 0;
+};
+
+// Animal is not the first base: call must adjust the object pointers.
+struct Dog : Tagged, Animal {
+    using Animal::Animal;
+};
+
+struct Cat : Animal {
+    using Animal::Animal;
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat);
+
+BOOST_OPENMETHOD(poke, (virtual_ptr<Animal>, std::string&), void);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    poke, (virtual_ptr<Dog> dog, std::string& out), void) {
+    out += dog->name + " barks; ";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    poke, (virtual_ptr<Cat> cat, std::string& out), void) {
+    out += cat->name + " hisses; ";
+}
+
+BOOST_OPENMETHOD(rename, (virtual_<Animal&>), void);
+
+BOOST_OPENMETHOD_OVERRIDE(rename, (Dog & dog), void) {
+    dog.name = "dog " + dog.name;
+}
+
+BOOST_OPENMETHOD_OVERRIDE(rename, (Cat & cat), void) {
+    cat.name = "cat " + cat.name;
+}
+
+BOOST_OPENMETHOD(
+    meet, (virtual_ptr<Animal>, virtual_ptr<Animal>, std::string&), void);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    meet, (virtual_ptr<Dog> dog, virtual_ptr<Cat>, std::string& out), void) {
+    out += dog->name + " chases; ";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    meet, (virtual_ptr<Cat> cat, virtual_ptr<Cat>, std::string& out), void) {
+    out += cat->name + " ignores; ";
+}
+
+using poke_method =
+    BOOST_OPENMETHOD_TYPE(poke, (virtual_ptr<Animal>, std::string&), void);
+using rename_method = BOOST_OPENMETHOD_TYPE(rename, (virtual_<Animal&>), void);
+using meet_method = BOOST_OPENMETHOD_TYPE(
+    meet, (virtual_ptr<Animal>, virtual_ptr<Animal>, std::string&), void);
+
+BOOST_AUTO_TEST_CASE(test_virtual_collection) {
+    initialize();
+
+    virtual_collection<Animal> animals;
+    BOOST_TEST(animals.empty());
+
+    animals.emplace<Dog>("Snoopy");
+    animals.insert(Cat("Felix"));
+    animals.emplace<Dog>("Hector");
+    BOOST_TEST(animals.size() == 3u);
+
+    // Objects are grouped by class, in the order the classes were first
+    // inserted.
+    std::string out;
+    animals.call(poke_method::fn, out);
+    BOOST_TEST(out == "Snoopy barks; Hector barks; Felix hisses; ");
+
+    animals.call(rename_method::fn);
+    out.clear();
+    animals.call(poke_method::fn, out);
+    BOOST_TEST(
+        out == "dog Snoopy barks; dog Hector barks; cat Felix hisses; ");
+
+    Cat tom("Tom");
+    out.clear();
+    animals.call(meet_method::fn, final_virtual_ptr(tom), out);
+    BOOST_TEST(
+        out == "dog Snoopy chases; dog Hector chases; cat Felix ignores; ");
+
+    animals.clear();
+    BOOST_TEST(animals.empty());
+    out.clear();
+    animals.call(poke_method::fn, out);
+    BOOST_TEST(out.empty());
+}
+
+} // namespace test_virtual_collection
+
+namespace test_missing_class {
+
+struct registry : test_registry_<__COUNTER__>::with<
+                      policies::runtime_checks, policies::throw_error_handler> {
+};
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+
+// Not registered.
+struct Cat : Animal {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, registry);
+
+BOOST_OPENMETHOD(poke, (virtual_ptr<Animal, registry>), void, registry);
+
+BOOST_OPENMETHOD_OVERRIDE(poke, (virtual_ptr<Dog, registry>), void) {
+}
+
+using poke_method = BOOST_OPENMETHOD_TYPE(
+    poke, (virtual_ptr<Animal, registry>), void, registry);
+
+BOOST_AUTO_TEST_CASE(virtual_collection_missing_class) {
+    initialize<registry>();
+
+    virtual_collection<Animal, registry> animals;
+    animals.emplace<Dog>();
+    animals.emplace<Cat>();
+
+    try {
+        animals.call(poke_method::fn);
+        BOOST_FAIL("missing_class not reported");
+    } catch (const missing_class& error) {
+        BOOST_TEST(error.type == registry::rtti::static_type<Cat>());
+    }
+}
+
+} // namespace test_missing_class
+
+namespace test_static_vptr {
+
+// Counts the calls to `dynamic_type`.
+struct counting_rtti : policies::std_rtti {
+    static inline std::size_t calls = 0;
+
+    template<class Registry>
+    struct fn : policies::std_rtti::fn<Registry> {
+        template<class Class>
+        static auto dynamic_type(const Class& obj) -> type_id {
+            ++calls;
+
+            return policies::std_rtti::fn<Registry>::dynamic_type(obj);
+        }
+    };
+};
+
+struct registry : test_registry_<__COUNTER__>::with<counting_rtti> {};
+
+struct Animal {
+    virtual ~Animal() {
+    }
+};
+
+struct Dog : Animal {};
+struct Cat : Animal {};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Dog, Cat, registry);
+
+BOOST_OPENMETHOD(name_ref, (virtual_<Animal&>, std::string&), void, registry);
+
+BOOST_OPENMETHOD_OVERRIDE(name_ref, (Dog&, std::string& out), void) {
+    out += "dog ";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(name_ref, (Cat&, std::string& out), void) {
+    out += "cat ";
+}
+
+BOOST_OPENMETHOD(name_ptr, (virtual_<Animal*>, std::string&), void, registry);
+
+BOOST_OPENMETHOD_OVERRIDE(name_ptr, (Dog*, std::string& out), void) {
+    out += "dog ";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(name_ptr, (Cat*, std::string& out), void) {
+    out += "cat ";
+}
+
+using name_ref_method = BOOST_OPENMETHOD_TYPE(
+    name_ref, (virtual_<Animal&>, std::string&), void, registry);
+using name_ptr_method = BOOST_OPENMETHOD_TYPE(
+    name_ptr, (virtual_<Animal*>, std::string&), void, registry);
+
+BOOST_AUTO_TEST_CASE(virtual_collection_static_vptr) {
+    initialize<registry>();
+
+    virtual_collection<Animal, registry> animals;
+    animals.emplace<Dog>();
+    animals.emplace<Cat>();
+    animals.emplace<Dog>();
+
+    counting_rtti::calls = 0;
+
+    std::string out;
+    animals.call(name_ref_method::fn, out);
+    BOOST_TEST(out == "dog dog cat ");
+
+    out.clear();
+    animals.call(name_ptr_method::fn, out);
+    BOOST_TEST(out == "dog dog cat ");
+
+    BOOST_TEST(counting_rtti::calls == 0u);
+}
+
+} // namespace test_static_vptr
@@ -8,6 +8,7 @@
 #include <boost/openmethod/interop/std_unique_ptr.hpp>
 #include <boost/openmethod/initialize.hpp>
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -121,6 +122,52 @@ BOOST_AUTO_TEST_CASE(test_virtual_shared_by_const_reference) {
 
 namespace BOOST_OPENMETHOD_GENSYM {
 
+// Overriders that take plain virtual_ptrs borrow the objects: the shared_ptrs
+// are not copied.
+struct BOOST_OPENMETHOD_ID(poke);
+using poke = method<
+    BOOST_OPENMETHOD_ID(poke),
+    void(const shared_virtual_ptr<Animal>&, std::ostream&)>;
+
+struct BOOST_OPENMETHOD_ID(poke_by_value);
+using poke_by_value = method<
+    BOOST_OPENMETHOD_ID(poke_by_value),
+    void(shared_virtual_ptr<Animal>, std::ostream&)>;
+
+const shared_virtual_ptr<Animal>* caller_ptr;
+
+void poke_dog(virtual_ptr<Dog> dog, std::ostream& os) {
+    BOOST_TEST(dog.get() == caller_ptr->get());
+    os << "bark " << caller_ptr->pointer().use_count();
+}
+
+BOOST_OPENMETHOD_REGISTER(poke::override<poke_dog>);
+BOOST_OPENMETHOD_REGISTER(poke_by_value::override<poke_dog>);
+
+BOOST_AUTO_TEST_CASE(test_virtual_shared_borrowed) {
+    boost::openmethod::initialize();
+
+    shared_virtual_ptr<Animal> animal = make_shared_virtual<Dog>();
+    caller_ptr = &animal;
+
+    {
+        boost::test_tools::output_test_stream os;
+        poke::fn(animal, os);
+        BOOST_CHECK(os.is_equal("bark 1"));
+    }
+
+    {
+        // One copy for the method's parameter.
+        boost::test_tools::output_test_stream os;
+        poke_by_value::fn(animal, os);
+        BOOST_CHECK(os.is_equal("bark 2"));
+    }
+}
+
+} // namespace BOOST_OPENMETHOD_GENSYM
+
+namespace BOOST_OPENMETHOD_GENSYM {
+
 BOOST_OPENMETHOD(poke, (unique_virtual_ptr<Animal>, std::ostream&), void);
 
 BOOST_OPENMETHOD_OVERRIDE(
@@ -139,6 +186,150 @@ BOOST_AUTO_TEST_CASE(test_virtual_unique) {
 }
 
 } // namespace BOOST_OPENMETHOD_GENSYM
+
+#ifdef __cpp_lib_memory_resource
+
+namespace BOOST_OPENMETHOD_GENSYM {
+
+using arena_delete =
+    allocator_delete<std::pmr::polymorphic_allocator<std::byte>>;
+
+BOOST_OPENMETHOD(
+    poke, (virtual_ptr<std::unique_ptr<Animal, arena_delete>>, std::ostream&),
+    void);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    poke,
+    (virtual_ptr<std::unique_ptr<Dog, arena_delete>>, std::ostream& os),
+    void) {
+    os << "bark";
+}
+
+BOOST_AUTO_TEST_CASE(test_virtual_unique_allocator) {
+    boost::openmethod::initialize();
+
+    alignas(std::max_align_t) char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(
+        buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    boost::test_tools::output_test_stream os;
+    virtual_ptr<std::unique_ptr<Animal, arena_delete>> animal =
+        allocate_unique_virtual<Dog>(&arena);
+    BOOST_TEST(
+        (animal.get() >= static_cast<void*>(buffer) &&
+         animal.get() < static_cast<void*>(buffer + sizeof(buffer))));
+    poke(std::move(animal), os);
+    BOOST_CHECK(os.is_equal("bark"));
+}
+
+// Animal is not the first base of Cat, so an Animal* to a Cat is not the
+// address of the Cat.
+struct Collar {
+    virtual ~Collar() {
+    }
+
+    int size = 0;
+};
+
+struct Cat : Collar, Animal {
+    static inline int destroyed = 0;
+
+    ~Cat() {
+        ++destroyed;
+    }
+};
+
+BOOST_OPENMETHOD_CLASSES(Animal, Cat);
+
+struct recording_resource : std::pmr::memory_resource {
+    void* allocated = nullptr;
+    std::size_t allocated_bytes = 0;
+    void* deallocated = nullptr;
+    std::size_t deallocated_bytes = 0;
+
+    auto do_allocate(std::size_t bytes, std::size_t alignment)
+        -> void* override {
+        allocated_bytes = bytes;
+        return allocated =
+                   std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+        override {
+        deallocated = p;
+        deallocated_bytes = bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+        -> bool override {
+        return this == &other;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(test_virtual_unique_allocator_base_conversion) {
+    boost::openmethod::initialize();
+
+    recording_resource resource;
+    Cat::destroyed = 0;
+
+    {
+        virtual_ptr<std::unique_ptr<Animal, arena_delete>> animal =
+            allocate_unique_virtual<Cat>(&resource);
+        BOOST_TEST(static_cast<void*>(animal.get()) != resource.allocated);
+    }
+
+    BOOST_TEST(Cat::destroyed == 1);
+    BOOST_TEST(resource.deallocated == resource.allocated);
+    BOOST_TEST(resource.deallocated_bytes == sizeof(Cat));
+    BOOST_TEST(resource.allocated_bytes == sizeof(Cat));
+}
+
+} // namespace BOOST_OPENMETHOD_GENSYM
+
+namespace BOOST_OPENMETHOD_GENSYM {
+
+BOOST_OPENMETHOD(
+    poke, (const shared_virtual_ptr<Animal>&, std::ostream&), void);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    poke, (const shared_virtual_ptr<Dog>&, std::ostream& os), void) {
+    os << "bark";
+}
+
+BOOST_AUTO_TEST_CASE(test_virtual_shared_allocator) {
+    boost::openmethod::initialize();
+
+    alignas(std::max_align_t) char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(
+        buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    auto in_arena = [&](const void* p) {
+        return p >= buffer && p < buffer + sizeof(buffer);
+    };
+
+    {
+        boost::test_tools::output_test_stream os;
+        shared_virtual_ptr<Animal> animal = allocate_shared_virtual<Dog>(
+            std::pmr::polymorphic_allocator<Dog>(&arena));
+        BOOST_TEST(in_arena(animal.get()));
+        poke(animal, os);
+        BOOST_CHECK(os.is_equal("bark"));
+    }
+
+    {
+        boost::test_tools::output_test_stream os;
+        shared_virtual_ptr<Animal> animal =
+            allocate_shared_virtual<Dog>(&arena);
+        BOOST_TEST(in_arena(animal.get()));
+        poke(animal, os);
+        BOOST_CHECK(os.is_equal("bark"));
+    }
+}
+
+} // namespace BOOST_OPENMETHOD_GENSYM
+
+#endif
 } // namespace using_polymorphic_classes
 
 namespace using_non_polymorphic_classes {
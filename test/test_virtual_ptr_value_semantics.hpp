@@ -67,8 +67,14 @@ struct direct_map
 
 struct indirect_map : direct_map::with<indirect_vptr> {};
 
+struct direct_flat_map : test_registry_<__COUNTER__>::with<
+                             vptr_map<flat_map_fn>>::without<type_hash> {};
+
+struct indirect_flat_map : direct_flat_map::with<indirect_vptr> {};
+
 using test_policies = boost::mp11::mp_list<
-    direct_vector, indirect_vector, direct_map, indirect_map>;
+    direct_vector, indirect_vector, direct_map, indirect_map, direct_flat_map,
+    indirect_flat_map>;
 
 using test_classes = boost::mp11::mp_list<Dog, Cat>;
 
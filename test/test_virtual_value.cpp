@@ -0,0 +1,97 @@
+// Copyright (c) 2018-2025 Jean-Louis Leroy
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt
+// or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstddef>
+#include <string>
+
+#include <boost/openmethod.hpp>
+#include <boost/openmethod/virtual_value.hpp>
+#include <boost/openmethod/initialize.hpp>
+
+#define BOOST_TEST_MODULE virtual_value
+#include <boost/test/unit_test.hpp>
+
+using namespace boost::openmethod;
+
+namespace test_virtual_value {
+
+struct Stack {
+    virtual ~Stack() {
+    }
+};
+
+struct BoundedStack : Stack {};
+
+BOOST_OPENMETHOD_CLASSES(Stack, BoundedStack);
+
+enum class opcode { push, pop, peek, count };
+
+using opcode_value = virtual_value<opcode, std::size_t(opcode::count)>;
+
+BOOST_OPENMETHOD_REGISTER(use_values<opcode_value>);
+
+BOOST_OPENMETHOD(
+    execute, (virtual_ptr<Stack>, virtual_<opcode_value>), std::string);
+
+BOOST_OPENMETHOD_OVERRIDE(
+    execute, (virtual_ptr<Stack>, opcode_value op), std::string) {
+    return "stack " + std::to_string(int(op.value()));
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    execute, (virtual_ptr<Stack>, value_constant<opcode::push>), std::string) {
+    return "stack push";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    execute, (virtual_ptr<BoundedStack>, value_constant<opcode::push>),
+    std::string) {
+    return "bounded push";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(
+    execute, (virtual_ptr<BoundedStack>, value_constant<opcode::pop>),
+    std::string) {
+    return "bounded pop";
+}
+
+// Integral values.
+using digit = virtual_value<int, 10>;
+
+BOOST_OPENMETHOD_REGISTER(use_values<digit>);
+
+BOOST_OPENMETHOD(parity, (virtual_<digit>), std::string);
+
+BOOST_OPENMETHOD_OVERRIDE(parity, (digit), std::string) {
+    return "odd";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(parity, (value_constant<0>), std::string) {
+    return "even";
+}
+
+BOOST_OPENMETHOD_OVERRIDE(parity, (value_constant<2>), std::string) {
+    return "even";
+}
+
+BOOST_AUTO_TEST_CASE(test_virtual_value) {
+    initialize();
+
+    Stack stack;
+    BoundedStack bounded;
+
+    BOOST_TEST(execute(stack, opcode::push) == "stack push");
+    BOOST_TEST(execute(stack, opcode::pop) == "stack 1");
+    BOOST_TEST(execute(bounded, opcode::push) == "bounded push");
+    BOOST_TEST(execute(bounded, opcode::pop) == "bounded pop");
+    BOOST_TEST(execute(bounded, opcode::peek) == "stack 2");
+
+    BOOST_TEST(parity(0) == "even");
+    BOOST_TEST(parity(1) == "odd");
+    BOOST_TEST(parity(2) == "even");
+    BOOST_TEST(parity(9) == "odd");
+}
+
+} // namespace test_virtual_value